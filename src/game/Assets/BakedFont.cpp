@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "BakedFont.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#if !defined( _WIN32 ) && !defined( CRIMILD_PLATFORM_EMSCRIPTEN )
+#define HUNGER_BAKED_FONT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace hunger;
+
+using namespace crimild;
+
+constexpr crimild::UInt32 BakedFont::MAGIC;
+constexpr crimild::UInt32 BakedFont::VERSION;
+constexpr crimild::Size BakedFont::GLYPH_COUNT;
+
+BakedFont::BakedFont( void )
+{
+
+}
+
+BakedFont::~BakedFont( void )
+{
+	unload();
+}
+
+crimild::Bool BakedFont::load( const std::string &fileName )
+{
+	unload();
+
+#ifdef HUNGER_BAKED_FONT_MMAP
+	auto fd = ::open( fileName.c_str(), O_RDONLY );
+	if ( fd < 0 ) {
+		return false;
+	}
+
+	struct stat info;
+	if ( ::fstat( fd, &info ) != 0 || info.st_size <= 0 ) {
+		::close( fd );
+		return false;
+	}
+
+	auto data = ::mmap( nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	::close( fd );
+	if ( data == MAP_FAILED ) {
+		return false;
+	}
+
+	_data = static_cast< const crimild::UInt8 * >( data );
+	_size = info.st_size;
+#else
+	std::ifstream file( fileName, std::ios::binary | std::ios::ate );
+	if ( !file ) {
+		return false;
+	}
+
+	_buffer.resize( file.tellg() );
+	file.seekg( 0 );
+	if ( !file.read( reinterpret_cast< char * >( _buffer.data() ), _buffer.size() ) ) {
+		_buffer.clear();
+		return false;
+	}
+
+	_data = _buffer.data();
+	_size = _buffer.size();
+#endif
+
+	if ( !validate( _size ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid baked font ", fileName );
+		unload();
+		return false;
+	}
+
+	return true;
+}
+
+crimild::Bool BakedFont::decodePixels( AtlasType type, std::vector< crimild::UInt8 > &pixels ) const
+{
+	const auto &atlas = getAtlas( type );
+	if ( atlas.width == 0 || atlas.height == 0 ) {
+		return false;
+	}
+
+	auto pixelCount = crimild::Size( atlas.width ) * atlas.height;
+	pixels.resize( pixelCount * atlas.channels );
+	return decodeRLE( _data + atlas.offset, atlas.size, atlas.channels, pixels.data(), pixelCount );
+}
+
+crimild::Bool BakedFont::decodeRLE( const crimild::UInt8 *src, crimild::Size srcSize, crimild::Size pixelSize, crimild::UInt8 *dst, crimild::Size pixelCount )
+{
+	auto end = src + srcSize;
+	crimild::Size i = 0;
+	while ( i < pixelCount ) {
+		if ( src >= end ) {
+			return false;
+		}
+
+		auto packet = *src++;
+		auto count = crimild::Size( packet & 0x7F ) + 1;
+		if ( i + count > pixelCount ) {
+			return false;
+		}
+
+		if ( packet & 0x80 ) {
+			// run: one pixel repeated count times
+			if ( crimild::Size( end - src ) < pixelSize ) {
+				return false;
+			}
+			for ( crimild::Size j = 0; j < count; j++ ) {
+				std::memcpy( dst + ( i + j ) * pixelSize, src, pixelSize );
+			}
+			src += pixelSize;
+		}
+		else {
+			// raw: count literal pixels
+			if ( crimild::Size( end - src ) < count * pixelSize ) {
+				return false;
+			}
+			std::memcpy( dst + i * pixelSize, src, count * pixelSize );
+			src += count * pixelSize;
+		}
+
+		i += count;
+	}
+
+	return true;
+}
+
+crimild::Bool BakedFont::validate( crimild::Size size )
+{
+	if ( size < sizeof( Header ) + GLYPH_COUNT * sizeof( Glyph ) ) {
+		return false;
+	}
+
+	auto header = reinterpret_cast< const Header * >( _data );
+	if ( header->magic != MAGIC || header->version != VERSION || header->glyphCount != GLYPH_COUNT || header->size != size ) {
+		return false;
+	}
+
+	// packets can't overlap the header or the glyph table
+	const auto firstPacket = sizeof( Header ) + GLYPH_COUNT * sizeof( Glyph );
+	for ( crimild::UInt32 i = 0; i < ATLAS_COUNT; i++ ) {
+		const auto &atlas = header->atlases[ i ];
+		if ( atlas.width == 0 || atlas.height == 0 ) {
+			// missing
+			continue;
+		}
+
+		if ( ( atlas.channels != 3 && atlas.channels != 4 ) || atlas.offset < firstPacket || atlas.offset > size || atlas.size > size - atlas.offset ) {
+			return false;
+		}
+
+		// a packet holds at most 128 pixels, which bounds what decodePixels() allocates
+		if ( crimild::UInt64( atlas.width ) * atlas.height > crimild::UInt64( atlas.size ) * 128 ) {
+			return false;
+		}
+	}
+
+	_header = header;
+	_glyphs = reinterpret_cast< const Glyph * >( _data + sizeof( Header ) );
+	return true;
+}
+
+void BakedFont::unload( void )
+{
+#ifdef HUNGER_BAKED_FONT_MMAP
+	if ( _data != nullptr ) {
+		::munmap( const_cast< crimild::UInt8 * >( _data ), _size );
+	}
+#endif
+	_buffer.clear();
+	_buffer.shrink_to_fit();
+
+	_data = nullptr;
+	_size = 0;
+	_header = nullptr;
+	_glyphs = nullptr;
+}
+
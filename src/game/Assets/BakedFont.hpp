@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_ASSETS_BAKED_FONT_
+#define HUNGER_ASSETS_BAKED_FONT_
+
+#include <Crimild.hpp>
+
+#include <string>
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief A font baked into a single binary blob
+
+	   The blob holds a glyph table indexed by character code and the
+	   atlas pixels, in RGB or RGBA (depending on the TGA's bit depth)
+	   with the bottom row first, as expected by glTexImage2D. Pixels
+	   are stored as TGA-style RLE packets, which keeps the blob about
+	   as small as the source files. The loader maps the file and
+	   points into it, so only the atlases are decoded.
+
+	   Blobs are written by the font baker tool in the host's byte
+	   order, which is little-endian on every supported platform.
+
+	   Layout:
+	   - Header
+	   - Glyph[ GLYPH_COUNT ]
+	   - RLE packets for each atlas
+	*/
+	class BakedFont {
+	public:
+		static constexpr crimild::UInt32 MAGIC = 0x544E4648; // "HFNT"
+		static constexpr crimild::UInt32 VERSION = 2;
+		static constexpr crimild::Size GLYPH_COUNT = 256;
+
+		enum AtlasType : crimild::UInt32 {
+			ATLAS_REGULAR = 0,
+			ATLAS_SDF = 1,
+			ATLAS_COUNT = 2,
+		};
+
+		/**
+		   \brief Same values, in the same order, as the text glyph files
+		*/
+		struct Glyph {
+			crimild::Real32 width;
+			crimild::Real32 height;
+			crimild::Real32 bearingX;
+			crimild::Real32 bearingY;
+			crimild::Real32 advance;
+			crimild::Real32 u;
+			crimild::Real32 v;
+			crimild::Real32 uOffset;
+			crimild::Real32 vOffset;
+		};
+
+		/**
+		   \brief An atlas image. A width or height of zero means the atlas is missing
+
+		   offset and size locate the RLE packets in the blob.
+		*/
+		struct Atlas {
+			crimild::UInt32 width;
+			crimild::UInt32 height;
+			crimild::UInt32 channels;
+			crimild::UInt32 offset;
+			crimild::UInt32 size;
+		};
+
+		struct Header {
+			crimild::UInt32 magic;
+			crimild::UInt32 version;
+			crimild::UInt32 glyphCount;
+			crimild::UInt32 size;
+			Atlas atlases[ ATLAS_COUNT ];
+		};
+
+	public:
+		BakedFont( void );
+		~BakedFont( void );
+
+		BakedFont( const BakedFont & ) = delete;
+		BakedFont &operator=( const BakedFont & ) = delete;
+
+		/**
+		   \brief Maps a baked font file. Returns false if it's missing or malformed
+		*/
+		crimild::Bool load( const std::string &fileName );
+
+		crimild::Bool isLoaded( void ) const { return _header != nullptr; }
+
+		const Glyph &getGlyph( unsigned char c ) const { return _glyphs[ c ]; }
+
+		const Atlas &getAtlas( AtlasType type ) const { return _header->atlases[ type ]; }
+
+		/**
+		   \brief Decodes an atlas into width * height * channels bytes
+
+		   Returns false if the atlas is missing or its packets are malformed.
+		*/
+		crimild::Bool decodePixels( AtlasType type, std::vector< crimild::UInt8 > &pixels ) const;
+
+		/**
+		   \brief Decodes pixelCount pixels of pixelSize bytes from TGA-style RLE packets
+
+		   Returns false if the packets end early or overflow the output.
+		*/
+		static crimild::Bool decodeRLE( const crimild::UInt8 *src, crimild::Size srcSize, crimild::Size pixelSize, crimild::UInt8 *dst, crimild::Size pixelCount );
+
+	private:
+		void unload( void );
+		crimild::Bool validate( crimild::Size size );
+
+	private:
+		const crimild::UInt8 *_data = nullptr;
+		crimild::Size _size = 0;
+		const Header *_header = nullptr;
+		const Glyph *_glyphs = nullptr;
+
+		/**
+		   Platforms without mmap read the file here instead
+		*/
+		std::vector< crimild::UInt8 > _buffer;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FontCache.hpp"
+#include "BakedFont.hpp"
+
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace hunger;
+
+using namespace crimild;
+
+namespace hunger {
+
+	namespace assets {
+
+		using FontFuture = std::shared_future< SharedPointer< Font > >;
+
+		std::mutex &getFontMutex( void )
+		{
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		std::unordered_map< std::string, FontFuture > &getFonts( void )
+		{
+			static std::unordered_map< std::string, FontFuture > fonts;
+			return fonts;
+		}
+
+#ifdef HUNGER_BAKED_FONTS
+
+		SharedPointer< Texture > createTexture( const BakedFont &baked, BakedFont::AtlasType type )
+		{
+			const auto &atlas = baked.getAtlas( type );
+			std::vector< crimild::UInt8 > pixels;
+			if ( !baked.decodePixels( type, pixels ) ) {
+				return nullptr;
+			}
+
+			// pixels are decoded in upload order, so no other conversion is needed
+			auto format = atlas.channels == 4 ? Image::PixelFormat::RGBA : Image::PixelFormat::RGB;
+			auto image = crimild::alloc< Image >( atlas.width, atlas.height, atlas.channels, pixels.data(), format );
+			return crimild::alloc< Texture >( image );
+		}
+
+		/**
+		   \brief Builds a font from a baked blob, without parsing any text or TGA files
+
+		   Needs a Font that can be filled in from memory, which is why
+		   this is only built with LD42_BAKE_FONTS.
+		*/
+		SharedPointer< Font > createFont( const BakedFont &baked )
+		{
+			auto font = crimild::alloc< Font >();
+			font->setTexture( createTexture( baked, BakedFont::ATLAS_REGULAR ) );
+			font->setSDFTexture( createTexture( baked, BakedFont::ATLAS_SDF ) );
+
+			for ( crimild::Size i = 0; i < BakedFont::GLYPH_COUNT; i++ ) {
+				auto symbol = static_cast< unsigned char >( i );
+				const auto &g = baked.getGlyph( symbol );
+				Font::Glyph glyph;
+				glyph.symbol = symbol;
+				glyph.width = g.width;
+				glyph.height = g.height;
+				glyph.bearingX = g.bearingX;
+				glyph.bearingY = g.bearingY;
+				glyph.advance = g.advance;
+				glyph.u = g.u;
+				glyph.v = g.v;
+				glyph.uOffset = g.uOffset;
+				glyph.vOffset = g.vOffset;
+				font->setGlyph( glyph );
+			}
+
+			return font;
+		}
+
+#endif
+
+		FontFuture loadFont( const std::string &path, std::launch policy )
+		{
+			// resolve the paths right away, in the calling thread
+			auto fileName = FileSystem::getInstance().pathForResource( path );
+#ifdef HUNGER_BAKED_FONTS
+			auto bakedFileName = fileName.substr( 0, fileName.find_last_of( '.' ) ) + ".font";
+			return std::async( policy, [ fileName, bakedFileName ] {
+				BakedFont baked;
+				if ( baked.load( bakedFileName ) ) {
+					return createFont( baked );
+				}
+
+				Log::debug( "FontCache", "No baked font for ", fileName, ". Parsing glyphs and atlases" );
+				return crimild::alloc< Font >( fileName );
+			}).share();
+#else
+			return std::async( policy, [ fileName ] {
+				return crimild::alloc< Font >( fileName );
+			}).share();
+#endif
+		}
+
+	}
+
+}
+
+SharedPointer< Font > FontCache::get( const std::string &path )
+{
+	assets::FontFuture font;
+
+	{
+		std::lock_guard< std::mutex > lock( assets::getFontMutex() );
+		auto &fonts = assets::getFonts();
+		auto it = fonts.find( path );
+		if ( it == fonts.end() ) {
+			it = fonts.insert( std::make_pair( path, assets::loadFont( path, std::launch::deferred ) ) ).first;
+		}
+		font = it->second;
+	}
+
+	// wait outside the lock so other fonts can be requested meanwhile
+	return font.get();
+}
+
+void FontCache::preload( const std::vector< std::string > &paths )
+{
+#ifdef CRIMILD_PLATFORM_EMSCRIPTEN
+	const auto policy = std::launch::deferred;
+#else
+	const auto policy = std::launch::async;
+#endif
+
+	std::lock_guard< std::mutex > lock( assets::getFontMutex() );
+	auto &fonts = assets::getFonts();
+	for ( const auto &path : paths ) {
+		if ( fonts.find( path ) == fonts.end() ) {
+			fonts.insert( std::make_pair( path, assets::loadFont( path, policy ) ) );
+		}
+	}
+}
+
+void FontCache::clear( void )
+{
+	std::unordered_map< std::string, assets::FontFuture > fonts;
+
+	{
+		std::lock_guard< std::mutex > lock( assets::getFontMutex() );
+		std::swap( fonts, assets::getFonts() );
+	}
+
+	// wait for pending loads before releasing them
+	for ( auto &it : fonts ) {
+		it.second.wait();
+	}
+}
+
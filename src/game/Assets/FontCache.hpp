@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_ASSETS_FONT_CACHE_
+#define HUNGER_ASSETS_FONT_CACHE_
+
+#include <Crimild.hpp>
+
+#include <string>
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Fonts shared by all scenes, keyed by resource path
+
+	   Fonts are loaded only the first time they're requested, and stay
+	   resident across scene changes until clear() is called. When
+	   built with HUNGER_BAKED_FONTS, a baked blob next to the glyph
+	   file (Verdana.font for Verdana.txt) is used when present.
+	   Otherwise the text glyph file and its TGA atlases are parsed.
+	*/
+	class FontCache {
+	public:
+		/**
+		   \brief Returns the font at the given resource path, loading it if needed
+
+		   If the font is still being preloaded, this waits for it.
+		*/
+		static crimild::SharedPointer< crimild::Font > get( const std::string &path );
+
+		/**
+		   \brief Starts loading the given fonts on a background thread
+
+		   On platforms without threads, fonts are loaded on first use instead.
+		*/
+		static void preload( const std::vector< std::string > &paths );
+
+		/**
+		   \brief Releases all cached fonts
+
+		   Must be called before the renderer is destroyed
+		*/
+		static void clear( void );
+	};
+
+}
+
+#endif
+
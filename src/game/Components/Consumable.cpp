@@ -28,12 +28,81 @@
 #include "Consumable.hpp"
 #include "Grid.hpp"
 #include "GridObject.hpp"
-#include "Player.hpp"
+
+#include <unordered_map>
 
 using namespace hunger;
 
 using namespace crimild;
 
+namespace hunger {
+
+	namespace assets {
+
+		/**
+		   Consumables only differ in size, so they all share the same
+		   few primitives and a single material. Sharing them also means
+		   each vertex buffer is uploaded once, no matter how many
+		   consumables are alive.
+		*/
+		std::unordered_map< crimild::Int32, SharedPointer< Primitive > > &getPrimitives( void )
+		{
+			static std::unordered_map< crimild::Int32, SharedPointer< Primitive > > primitives;
+			return primitives;
+		}
+
+		std::unordered_map< crimild::UInt32, SharedPointer< Material > > &getMaterials( void )
+		{
+			static std::unordered_map< crimild::UInt32, SharedPointer< Material > > materials;
+			return materials;
+		}
+
+		crimild::UInt32 packColor( const RGBAColorf &c )
+		{
+			auto channel = []( crimild::Real32 v ) -> crimild::UInt32 {
+				return crimild::UInt32( Numericf::clamp( v, 0.0f, 1.0f ) * 255.0f + 0.5f );
+			};
+			return ( channel( c.r() ) << 24 ) | ( channel( c.g() ) << 16 ) | ( channel( c.b() ) << 8 ) | channel( c.a() );
+		}
+
+	}
+
+}
+
+SharedPointer< Primitive > Consumable::getSharedPrimitive( crimild::Int32 size )
+{
+	auto &primitives = assets::getPrimitives();
+	auto it = primitives.find( size );
+	if ( it != primitives.end() ) {
+		return it->second;
+	}
+
+	auto primitive = crimild::alloc< SpherePrimitive >( size );
+	primitives[ size ] = primitive;
+	return primitive;
+}
+
+SharedPointer< Material > Consumable::getSharedMaterial( const RGBAColorf &diffuse )
+{
+	auto &materials = assets::getMaterials();
+	auto key = assets::packColor( diffuse );
+	auto it = materials.find( key );
+	if ( it != materials.end() ) {
+		return it->second;
+	}
+
+	auto material = crimild::alloc< Material >();
+	material->setDiffuse( diffuse );
+	materials[ key ] = material;
+	return material;
+}
+
+void Consumable::releaseSharedAssets( void )
+{
+	assets::getPrimitives().clear();
+	assets::getMaterials().clear();
+}
+
 Consumable::Consumable( void )
 {
 
@@ -46,17 +115,14 @@ Consumable::~Consumable( void )
 
 void Consumable::onAttach( void )
 {
-	_size = Random::generate< crimild::Int32 >( 1, 6 );
-	
 	auto parent = getNode< Group >();
 	
 	auto g = crimild::alloc< Geometry >();
-	g->attachPrimitive( crimild::alloc< SpherePrimitive >( _size ) );
+	g->attachPrimitive( getSharedPrimitive( _size ) );
 	parent->attachNode( g );
+	_geometry = crimild::get_ptr( g );
 	
-	auto m = crimild::alloc< Material >();
-	m->setDiffuse( RGBAColorf( 0.0f, 1.0f, 0.0f, 1.0f ) );
-	g->getComponent< MaterialComponent >()->attachMaterial( m );
+	g->getComponent< MaterialComponent >()->attachMaterial( getSharedMaterial( RGBAColorf( 0.0f, 1.0f, 0.0f, 1.0f ) ) );
 }
 
 void Consumable::start( void )
@@ -68,20 +134,20 @@ void Consumable::start( void )
 	getNode()->local().setTranslate( grid->gridPosToWorld( gridPos ) );
 }
 
-void Consumable::update( const Clock & )
+void Consumable::place( const Vector2i &pos, crimild::Int32 size )
 {
-	auto player = Player::getInstance();
-	auto playerHead = player->getHead();
-	if ( playerHead == nullptr ) {
-		return;
-	}
+	auto gridObject = getComponent< GridObject >();
+	auto grid = gridObject->getGrid();
 
-	if ( getNode()->getWorldBound()->testIntersection( playerHead->getWorldBound() ) ) {
-		broadcastMessage( messaging::ConsumableDestroyed { } );
-		crimild::concurrency::sync_frame( [ this ] {
-			getNode()->detachFromParent();
-		});
+	if ( size != _size ) {
+		_size = size;
+		_geometry->detachAllPrimitives();
+		_geometry->attachPrimitive( getSharedPrimitive( _size ) );
 	}
-	
-}
 
+	gridObject->setPosition( pos );
+
+	getNode()->local().setTranslate( grid->gridPosToWorld( pos ) );
+	getNode()->perform( UpdateWorldState() );
+	getNode()->setEnabled( true );
+}
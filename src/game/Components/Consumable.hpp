@@ -32,16 +32,6 @@
 
 namespace hunger {
 
-	class Consumable;
-
-	namespace messaging {
-
-		struct ConsumableDestroyed {
-			Consumable *consumable;
-		};
-
-	}
-
 	class Consumable :
 		public crimild::NodeComponent,
 		public crimild::Messenger {
@@ -53,12 +43,32 @@ namespace hunger {
 		
 		virtual void onAttach( void ) override;
 		virtual void start( void ) override;
-		virtual void update( const crimild::Clock & ) override;
 
 		crimild::Int32 getSize( void ) const { return _size; }
 
+		/**
+		   \brief Moves this consumable to the given cell and size, without registering it in the grid
+
+		   Only touches this consumable's own transforms, so recycled
+		   consumables are much cheaper than new node hierarchies.
+		*/
+		void place( const crimild::Vector2i &pos, crimild::Int32 size );
+
+	public:
+		/**
+		   \brief Releases the geometry and materials shared by all consumables
+
+		   Must be called before the renderer is destroyed
+		*/
+		static void releaseSharedAssets( void );
+
+	private:
+		static crimild::SharedPointer< crimild::Primitive > getSharedPrimitive( crimild::Int32 size );
+		static crimild::SharedPointer< crimild::Material > getSharedMaterial( const crimild::RGBAColorf &diffuse );
+
 	private:
 		crimild::Int32 _size = 3;
+		crimild::Geometry *_geometry = nullptr;
 	};
 	
 }
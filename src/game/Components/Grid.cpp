@@ -26,23 +26,36 @@
  */
 
 #include "Grid.hpp"
-#include "Player.hpp"
-#include "Consumable.hpp"
-#include "GridObject.hpp"
+
+#include "Messaging/GameEvents.hpp"
+
+#include <algorithm>
+#include <utility>
 
 using namespace hunger;
 using namespace hunger::messaging;
 
 using namespace crimild;
 
-Grid::Grid( crimild::Int32 width, crimild::Int32 height )
+constexpr crimild::Int64 Grid::DENSE_CELL_LIMIT;
+constexpr crimild::Int32 Grid::SPARSE_SAMPLE_ATTEMPTS;
+constexpr crimild::Int32 Grid::FREE_BLOCK_WORDS;
+
+Grid::Grid( crimild::Int32 width, crimild::Int32 height, crimild::UInt64 seed )
 	: _width( width ),
 	  _height( height ),
-	  _state( _width * _height )
+	  _topology( width, height ),
+	  _random( seed ),
+	  _sparse( crimild::Int64( width ) * height > DENSE_CELL_LIMIT ),
+	  _occupied( _sparse ? 0 : _width, _sparse ? 0 : _height ),
+	  _sparseOccupied( _sparse ? new SparseBitGrid( _width, _height ) : nullptr ),
+	  _blocked( _sparse ? 0 : _width, _sparse ? 0 : _height ),
+	  _wordFree( _blocked.getWordCount() ),
+	  _blockFree( ( _blocked.getWordCount() + FREE_BLOCK_WORDS - 1 ) / FREE_BLOCK_WORDS ),
+	  _events( new messaging::GameEvents() )
 {
-	_state.each( []( crimild::Bool &s ) {
-		s = false;
-	});
+	clear();
+	computeWorldTables();
 }
 
 Grid::~Grid( void)
@@ -50,87 +63,356 @@ Grid::~Grid( void)
 	
 }
 
-void Grid::onAttach( void )
+void Grid::clear( void )
 {
-	spawnPlayer();
-	for ( crimild::Int32 i = 0; i < 5; i++ ) {
-		spawnConsumable();
+	_occupied.clear();
+	if ( _sparseOccupied != nullptr ) {
+		_sparseOccupied->clear();
 	}
+	_consumables.clear();
+	_events->clear();
+
+	rebuildFreeIndex();
 }
 
-void Grid::start( void )
+void Grid::reset( crimild::UInt64 seed )
 {
-	registerMessageHandler< ConsumableDestroyed >( [ this ]( ConsumableDestroyed const & ) {
-		crimild::concurrency::sync_frame( [ this ] {
-			spawnConsumable();
-		});
-	});
+	_random = RandomStreams( seed );
+	clear();
 }
 
-crimild::Bool Grid::isEmpty( crimild::Vector2i pos ) const
+crimild::Size Grid::countEmpty( void ) const
 {
-	return !_state[ pos.y() * _width + pos.x() ];
+	return crimild::Size( _width ) * _height - ( _sparse ? _sparseOccupied->count() : _occupied.count() );
 }
 
-void Grid::setEmpty( crimild::Vector2i pos, crimild::Bool empty )
+crimild::Int32 Grid::findNextEmpty( crimild::Int32 x, crimild::Int32 y ) const
 {
-	_state[ pos.y() * _width + pos.x() ] = !empty;
+	if ( _sparse ) {
+		for ( ; x < _width; x++ ) {
+			if ( !_sparseOccupied->test( x, y ) ) {
+				return x;
+			}
+		}
+		return -1;
+	}
+
+	return _occupied.findNextClear( x, y );
 }
 
-crimild::Bool Grid::move( crimild::Vector2i &pos )
+crimild::Bool Grid::isRowSegmentEmpty( crimild::Int32 x0, crimild::Int32 x1, crimild::Int32 y ) const
 {
-	pos.x() = ( getWidth() + pos.x() ) % getWidth();
-	pos.y() = ( getHeight() + pos.y() ) % getHeight();
-	/*
-	  if ( gridPos.y() < 0 || gridPos.y() >= getHeight() ) {
-	  return false;
-	  }
-	*/
-	
-	if ( !isEmpty( pos ) ) {
+	if ( _sparse ) {
+		for ( auto x = x0; x < x1; x++ ) {
+			if ( _sparseOccupied->test( x, y ) ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	return !_occupied.anyInRow( x0, x1, y );
+}
+
+crimild::Bool Grid::isRectEmpty( crimild::Int32 x, crimild::Int32 y, crimild::Int32 width, crimild::Int32 height ) const
+{
+	if ( _sparse ) {
+		for ( auto row = y; row < y + height; row++ ) {
+			if ( !isRowSegmentEmpty( x, x + width, row ) ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	return !_occupied.any( x, y, width, height );
+}
+
+crimild::Size Grid::getFreeCellCount( void ) const
+{
+	if ( _sparse ) {
+		// the snake never overlaps a consumable
+		return countEmpty() - _consumables.size();
+	}
+
+	return _freeCount;
+}
+
+crimild::Size Grid::getOccupancyMemoryUsage( void ) const
+{
+	return _sparse ? _sparseOccupied->getMemoryUsage() : _occupied.getWordCount() * sizeof( BitGrid::Word );
+}
+
+Vector2i Grid::getFreeCell( crimild::Size index ) const
+{
+	crimild::Size block = 0;
+	while ( index >= crimild::Size( _blockFree[ block ] ) ) {
+		index -= _blockFree[ block++ ];
+	}
+
+	auto word = crimild::Int32( block ) * FREE_BLOCK_WORDS;
+	while ( index >= _wordFree[ word ] ) {
+		index -= _wordFree[ word++ ];
+	}
+
+	auto free = ~_blocked.getWords()[ word ] & getValidBits( word );
+	for ( ; index > 0; index-- ) {
+		free &= free - 1;
+	}
+
+	auto stride = _blocked.getStride();
+	return Vector2i( ( word % stride ) * BitGrid::WORD_BITS + bits::countTrailingZeros( free ), word / stride );
+}
+
+crimild::Bool Grid::sampleFreeCell( Vector2i &pos )
+{
+	if ( _sparse ) {
+		// most cells are free, so a few attempts are enough
+		for ( crimild::Int32 i = 0; i < SPARSE_SAMPLE_ATTEMPTS; i++ ) {
+			Vector2i cell;
+			cell.x() = _random.spawn.generate( _width );
+			cell.y() = _random.spawn.generate( _height );
+			if ( isEmpty( cell ) && !hasConsumable( cell ) ) {
+				pos = cell;
+				return true;
+			}
+		}
 		return false;
 	}
-	
-	setEmpty( pos, false );
-	
+
+	if ( _freeCount == 0 ) {
+		return false;
+	}
+
+	pos = getFreeCell( _random.spawn.generate( crimild::Int32( _freeCount ) ) );
 	return true;
 }
 
-Vector3f Grid::gridPosToWorld( const Vector2i gridPos ) const
+void Grid::setFree( crimild::Int32 word, crimild::Int32 bit, crimild::Bool free )
 {
-	auto u = Numericf::TWO_PI * gridPos.x() / ( getWidth() - 1.0f );
-	auto v = 0.75f * gridPos.y() / ( getHeight() - 1.0f );
-	auto r = 0.5f * getWidth();
-	auto h = getHeight();
-	auto x = r * ( 1.0f - v ) * std::cos( u );
-	auto y = h * ( v - 0.5f );
-	auto z = r * ( 1.0f - v ) * -std::sin( u );
-	
-	return Vector3f( x, y, z );
+	auto &w = _blocked.getWords()[ word ];
+	auto mask = BitGrid::Word( 1 ) << bit;
+	if ( free == ( ( w & mask ) == 0 ) ) {
+		return;
+	}
+
+	w ^= mask;
+	if ( free ) {
+		++_wordFree[ word ];
+		++_blockFree[ word / FREE_BLOCK_WORDS ];
+		++_freeCount;
+	}
+	else {
+		--_wordFree[ word ];
+		--_blockFree[ word / FREE_BLOCK_WORDS ];
+		--_freeCount;
+	}
 }
 
-void Grid::spawnPlayer( void )
+void Grid::rebuildFreeIndex( void )
 {
-	auto player = crimild::alloc< Group >();
-	player->attachComponent< Player >();
-	player->attachComponent< GridObject >( this );
+	if ( _sparse ) {
+		_freeCount = 0;
+		return;
+	}
+
+	auto blocked = _blocked.getWords();
+	std::copy( _occupied.getWords(), _occupied.getWords() + _occupied.getWordCount(), blocked );
+	for ( const auto &it : _consumables ) {
+		auto cell = _topology.getCell( it.first );
+		blocked[ _topology.getWordIndex( cell ) ] |= BitGrid::Word( 1 ) << ( cell.x() & 63 );
+	}
 
-	auto parent = getNode< Group >();
-	parent->attachNode( player );
+	_freeCount = 0;
+	std::fill( _blockFree.begin(), _blockFree.end(), 0 );
+	for ( crimild::Int32 word = 0; word < crimild::Int32( _wordFree.size() ); word++ ) {
+		auto free = bits::popCount( ~blocked[ word ] & getValidBits( word ) );
+		_wordFree[ word ] = crimild::UInt8( free );
+		_blockFree[ word / FREE_BLOCK_WORDS ] += crimild::Int32( free );
+		_freeCount += free;
+	}
 }
 
-void Grid::spawnConsumable( crimild::Bool startComponents )
+BitGrid::Word Grid::getValidBits( crimild::Int32 word ) const
 {
-	auto consumable = crimild::alloc< Group >();
-	consumable->attachComponent< Consumable >();
-	consumable->attachComponent< GridObject >( this );
-	
-	auto parent = getNode< Group >();
-	parent->attachNode( consumable );
-	if ( startComponents ) {
-		consumable->perform( UpdateRenderState() );
-		consumable->perform( UpdateWorldState() );
-		consumable->startComponents();
+	// only the last word of each row has padding bits
+	auto stride = _blocked.getStride();
+	if ( word % stride < stride - 1 || _width % BitGrid::WORD_BITS == 0 ) {
+		return ~BitGrid::Word( 0 );
+	}
+	return ~( ~BitGrid::Word( 0 ) << ( _width % BitGrid::WORD_BITS ) );
+}
+
+crimild::Int32 Grid::spawnConsumable( Vector2i &pos )
+{
+	if ( !sampleFreeCell( pos ) ) {
+		return 0;
+	}
+
+	auto size = _random.spawn.generate( 1, 6 );
+	addConsumable( pos, size );
+	return size;
+}
+
+void Grid::addConsumable( const Vector2i &pos, crimild::Int32 size, Consumable *consumable )
+{
+	auto index = _topology.getIndex( pos );
+	auto &cell = _consumables[ index ];
+	cell.size = size;
+	cell.consumable = consumable;
+	if ( !_sparse ) {
+		setFree( _topology.getWordIndex( pos ), pos.x() & 63, false );
+	}
+}
+
+void Grid::removeConsumable( const Vector2i &pos )
+{
+	auto index = _topology.getIndex( pos );
+	if ( _consumables.erase( index ) > 0 && !_sparse ) {
+		setFree( _topology.getWordIndex( pos ), pos.x() & 63, isEmpty( pos ) );
+	}
+}
+
+crimild::Bool Grid::hasConsumable( const Vector2i &pos ) const
+{
+	return _consumables.find( _topology.getIndex( pos ) ) != _consumables.end();
+}
+
+void Grid::gridPosToWorld( const Vector2i *gridPos, Vector3f *worldPos, crimild::Size count ) const
+{
+	auto cosU = _columnCos.data();
+	auto sinU = _columnSin.data();
+	auto radius = _rowRadius.data();
+	auto height = _rowHeight.data();
+
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		auto x = gridPos[ i ].x();
+		auto y = gridPos[ i ].y();
+		auto r = radius[ y ];
+		worldPos[ i ] = Vector3f( r * cosU[ x ], height[ y ], r * sinU[ x ] );
+	}
+}
+
+void Grid::save( Snapshot &snapshot ) const
+{
+	snapshot.write( _width );
+	snapshot.write( _height );
+
+	snapshot.write( _random.seed );
+	snapshot.write( _random.spawn.getCounter() );
+	snapshot.write( _random.gameplay.getCounter() );
+	snapshot.write( _random.particles.getCounter() );
+
+	if ( _sparse ) {
+		snapshot.write( crimild::UInt64( _sparseOccupied->getChunkCount() ) );
+		_sparseOccupied->eachChunk( [ &snapshot ]( crimild::Int32 chunkX, crimild::Int32 chunkY, const SparseBitGrid::Chunk &chunk ) {
+			snapshot.write( chunkX );
+			snapshot.write( chunkY );
+			snapshot.write( chunk.rows, sizeof( chunk.rows ) );
+		});
+	}
+	else {
+		snapshot.write( _occupied.getWords(), _occupied.getWordCount() * sizeof( BitGrid::Word ) );
+	}
+
+	snapshot.write( crimild::UInt64( _consumables.size() ) );
+	for ( const auto &it : _consumables ) {
+		snapshot.write( it.first );
+		snapshot.write( it.second.size );
+	}
+}
+
+crimild::Bool Grid::restore( Snapshot &snapshot )
+{
+	auto width = snapshot.read< crimild::Int32 >();
+	auto height = snapshot.read< crimild::Int32 >();
+	if ( !snapshot.good() || width != _width || height != _height ) {
+		return false;
+	}
+
+	auto seed = snapshot.read< crimild::UInt64 >();
+	auto spawnCounter = snapshot.read< crimild::UInt64 >();
+	auto gameplayCounter = snapshot.read< crimild::UInt64 >();
+	auto particlesCounter = snapshot.read< crimild::UInt64 >();
+
+	// read everything before touching the grid
+	BitGrid occupied( _sparse ? 0 : _width, _sparse ? 0 : _height );
+	std::unique_ptr< SparseBitGrid > sparseOccupied( _sparse ? new SparseBitGrid( _width, _height ) : nullptr );
+	if ( _sparse ) {
+		const auto chunkColumns = ( _width + SparseBitGrid::CHUNK_SIZE - 1 ) / SparseBitGrid::CHUNK_SIZE;
+		const auto chunkRows = ( _height + SparseBitGrid::CHUNK_SIZE - 1 ) / SparseBitGrid::CHUNK_SIZE;
+		auto chunkCount = snapshot.read< crimild::UInt64 >();
+		for ( crimild::UInt64 i = 0; i < chunkCount && snapshot.good(); i++ ) {
+			auto chunkX = snapshot.read< crimild::Int32 >();
+			auto chunkY = snapshot.read< crimild::Int32 >();
+			SparseBitGrid::Word rows[ SparseBitGrid::CHUNK_SIZE ];
+			snapshot.read( rows, sizeof( rows ) );
+			if ( chunkX < 0 || chunkX >= chunkColumns || chunkY < 0 || chunkY >= chunkRows ) {
+				return false;
+			}
+			sparseOccupied->setChunk( chunkX, chunkY, rows );
+		}
+	}
+	else {
+		snapshot.read( occupied.getWords(), occupied.getWordCount() * sizeof( BitGrid::Word ) );
 	}
+
+	auto cellCount = crimild::Int64( _width ) * _height;
+
+	std::vector< std::pair< crimild::Int64, crimild::Int32 > > consumables( snapshot.read< crimild::UInt64 >() );
+	if ( !snapshot.good() || consumables.size() > crimild::Size( cellCount ) ) {
+		return false;
+	}
+	for ( auto &c : consumables ) {
+		c.first = snapshot.read< crimild::Int64 >();
+		c.second = snapshot.read< crimild::Int32 >();
+		if ( c.first < 0 || c.first >= cellCount ) {
+			return false;
+		}
+	}
+
+	if ( !snapshot.good() ) {
+		return false;
+	}
+
+	std::copy( occupied.getWords(), occupied.getWords() + occupied.getWordCount(), _occupied.getWords() );
+	_sparseOccupied = std::move( sparseOccupied );
+
+	_consumables.clear();
+	for ( const auto &c : consumables ) {
+		auto &cell = _consumables[ c.first ];
+		cell.size = c.second;
+		cell.consumable = nullptr;
+	}
+
+	rebuildFreeIndex();
+
+	_random = RandomStreams( seed );
+	_random.spawn.setCounter( spawnCounter );
+	_random.gameplay.setCounter( gameplayCounter );
+	_random.particles.setCounter( particlesCounter );
+
+	return true;
 }
 
+void Grid::computeWorldTables( void )
+{
+	auto r = 0.5f * getWidth();
+	auto h = getHeight();
+
+	_columnCos.resize( _width );
+	_columnSin.resize( _width );
+	for ( crimild::Int32 x = 0; x < _width; x++ ) {
+		auto u = Numericf::TWO_PI * x / ( getWidth() - 1.0f );
+		_columnCos[ x ] = std::cos( u );
+		_columnSin[ x ] = -std::sin( u );
+	}
+
+	_rowRadius.resize( _height );
+	_rowHeight.resize( _height );
+	for ( crimild::Int32 y = 0; y < _height; y++ ) {
+		auto v = 0.75f * y / ( getHeight() - 1.0f );
+		_rowRadius[ y ] = r * ( 1.0f - v );
+		_rowHeight[ y ] = h * ( v - 0.5f );
+	}
+}
@@ -28,40 +28,325 @@
 #ifndef HUNGER_COMPONENTS_GRID_
 #define HUNGER_COMPONENTS_GRID_
 
+#include "Logic/BitGrid.hpp"
+#include "Logic/GridTopology.hpp"
+#include "Logic/SparseBitGrid.hpp"
+#include "Logic/RandomStream.hpp"
+#include "Logic/Snapshot.hpp"
+
 #include <Crimild.hpp>
 
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace hunger {
 
-	class Grid :
-		public crimild::NodeComponent,
-		public crimild::Messenger {
+	class Consumable;
+
+	namespace messaging {
+
+		struct GameEvents;
+
+	}
+
+	class Grid : public crimild::NodeComponent {
 		CRIMILD_IMPLEMENT_RTTI( hunger::Grid )
 		
 	public:
-		Grid( crimild::Int32 width, crimild::Int32 height );
-		virtual ~Grid( void );
+		/**
+		   \brief A consumable registered in a grid cell
+
+		   A size of zero means no consumable was picked up.
+		   The consumable component is null for headless worlds.
+		*/
+		struct Pickup {
+			crimild::Int32 size = 0;
+			Consumable *consumable = nullptr;
+		};
 
-		virtual void onAttach( void ) override;
-		virtual void start( void ) override;
+		/**
+		   Grids with more cells than this store occupancy in a
+		   SparseBitGrid and keep no free cell index.
+		*/
+		static constexpr crimild::Int64 DENSE_CELL_LIMIT = crimild::Int64( 1 ) << 24;
+
+		/**
+		   Attempts made by sampleFreeCell() on sparse grids before
+		   giving up.
+		*/
+		static constexpr crimild::Int32 SPARSE_SAMPLE_ATTEMPTS = 64;
+
+	public:
+		/**
+		   \param seed Seeds all random streams of this grid. The same
+		   seed and the same inputs replay the same game.
+		*/
+		Grid( crimild::Int32 width, crimild::Int32 height, crimild::UInt64 seed = 0 );
+		virtual ~Grid( void );
 		
 		crimild::Int32 getWidth( void ) const { return _width; }
 		crimild::Int32 getHeight( void ) const { return _height; }
+
+		/**
+		   \brief Tells if occupancy is stored in chunks. See DENSE_CELL_LIMIT
+		*/
+		crimild::Bool isSparse( void ) const { return _sparse; }
+
+		/**
+		   \brief Runtime wraparound and index arithmetic for this grid
+		*/
+		const GridTopology &getTopology( void ) const { return _topology; }
+
+		/**
+		   \brief Calls fn with the fastest topology for this grid's size
+
+		   See dispatchGridTopology(). Used to run a whole step with
+		   compile-time dimensions when the size allows it.
+		*/
+		template< typename Fn >
+		auto withTopology( Fn fn ) const -> decltype( fn( std::declval< const GridTopology & >() ) )
+		{
+			return dispatchGridTopology( _topology, fn );
+		}
+
+		/**
+		   \brief Random streams for everything living in this grid
+		*/
+		RandomStreams &getRandom( void ) { return _random; }
+
+		/**
+		   \brief Gameplay events of this world. See messaging::GameEvents
+		*/
+		messaging::GameEvents &getEvents( void ) { return *_events; }
 		
-		crimild::Bool isEmpty( crimild::Vector2i pos ) const;
-		void setEmpty( crimild::Vector2i pos, crimild::Bool empty );
+		void clear( void );
+
+		/**
+		   \brief Clears the grid and restarts its random streams with the given seed
+		*/
+		void reset( crimild::UInt64 seed );
+
+		crimild::Bool isEmpty( crimild::Vector2i pos ) const { return isEmpty( _topology, pos ); }
+		void setEmpty( crimild::Vector2i pos, crimild::Bool empty ) { setEmpty( _topology, pos, empty ); }
+
+		/**
+		   \brief Same as isEmpty( pos ), with the given topology for this grid's size
+		*/
+		template< typename Topology >
+		crimild::Bool isEmpty( const Topology &topology, crimild::Vector2i pos ) const
+		{
+			// compile-time topologies are always dense
+			if ( !Topology::IS_STATIC && _sparse ) {
+				return !_sparseOccupied->test( pos.x(), pos.y() );
+			}
+
+			return !( ( _occupied.getWords()[ topology.getWordIndex( pos ) ] >> ( pos.x() & 63 ) ) & 1 );
+		}
+
+		template< typename Topology >
+		void setEmpty( const Topology &topology, crimild::Vector2i pos, crimild::Bool empty )
+		{
+			if ( !Topology::IS_STATIC && _sparse ) {
+				_sparseOccupied->set( pos.x(), pos.y(), !empty );
+				return;
+			}
+
+			auto &w = _occupied.getWords()[ topology.getWordIndex( pos ) ];
+			auto bit = BitGrid::Word( 1 ) << ( pos.x() & 63 );
+			w = empty ? ( w & ~bit ) : ( w | bit );
+
+			setFree( topology.getWordIndex( pos ), pos.x() & 63, empty && ( _consumables.empty() || _consumables.find( topology.getIndex( pos ) ) == _consumables.end() ) );
+		}
+
+		/**
+		   \brief Bit-packed occupancy. A set bit means the cell is occupied
+
+		   Empty for sparse grids.
+		*/
+		const BitGrid &getOccupancy( void ) const { return _occupied; }
+
+		/**
+		   \brief Number of cells not occupied by the snake
+		*/
+		crimild::Size countEmpty( void ) const;
+
+		/**
+		   \brief First empty cell in row y at or after x, or -1 if none
+		*/
+		crimild::Int32 findNextEmpty( crimild::Int32 x, crimild::Int32 y ) const;
+
+		/**
+		   \brief Tests if all cells in [x0, x1) of row y are empty. Does not wrap
+		*/
+		crimild::Bool isRowSegmentEmpty( crimild::Int32 x0, crimild::Int32 x1, crimild::Int32 y ) const;
+
+		/**
+		   \brief Tests if all cells in the given rectangle are empty. Does not wrap
+		*/
+		crimild::Bool isRectEmpty( crimild::Int32 x, crimild::Int32 y, crimild::Int32 width, crimild::Int32 height ) const;
+
+		/**
+		   \brief Number of cells that are neither occupied nor holding a consumable
+		*/
+		crimild::Size getFreeCellCount( void ) const;
+
+		/**
+		   \brief Returns the free cell at the given index, in [0, getFreeCellCount())
+
+		   Free cells are numbered in row order. Dense grids only.
+		*/
+		crimild::Vector2i getFreeCell( crimild::Size index ) const;
+
+		/**
+		   \brief Picks a random free cell
+
+		   Returns false only if there are no free cells left. Sparse
+		   grids draw random cells until one is free instead, and give
+		   up after SPARSE_SAMPLE_ATTEMPTS.
+		*/
+		crimild::Bool sampleFreeCell( crimild::Vector2i &pos );
 		
-		crimild::Bool move( crimild::Vector2i &pos );
+		/**
+		   \brief Wraps pos around the grid and occupies that cell
+
+		   Returns false if the cell is already occupied. If the cell
+		   holds a consumable, it is unregistered and reported in pickup.
+		*/
+		crimild::Bool move( crimild::Vector2i &pos, Pickup *pickup = nullptr ) { return move( _topology, pos, pickup ); }
+
+		/**
+		   \brief Same as move( pos, pickup ), with the given topology for this grid's size
+		*/
+		template< typename Topology >
+		crimild::Bool move( const Topology &topology, crimild::Vector2i &pos, Pickup *pickup = nullptr )
+		{
+			pos = topology.wrap( pos );
+
+			if ( !isEmpty( topology, pos ) ) {
+				return false;
+			}
+
+			setEmpty( topology, pos, false );
+
+			if ( !_consumables.empty() ) {
+				auto it = _consumables.find( topology.getIndex( pos ) );
+				if ( it != _consumables.end() ) {
+					if ( pickup != nullptr ) {
+						*pickup = it->second;
+					}
+					_consumables.erase( it );
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		   \brief Registers a consumable of random size on a random free cell
+
+		   Returns its size and writes its cell to pos, or returns zero
+		   if there are no free cells left. The consumable has no node.
+		   See GridSpawner
+		*/
+		crimild::Int32 spawnConsumable( crimild::Vector2i &pos );
+
+		void addConsumable( const crimild::Vector2i &pos, crimild::Int32 size, Consumable *consumable = nullptr );
+		void removeConsumable( const crimild::Vector2i &pos );
+		crimild::Bool hasConsumable( const crimild::Vector2i &pos ) const;
+		crimild::Size getConsumableCount( void ) const { return _consumables.size(); }
+
+		/**
+		   \brief Bytes used to store occupancy
+		*/
+		crimild::Size getOccupancyMemoryUsage( void ) const;
+
+		/**
+		   \brief Calls fn( cell, size ) for each registered consumable, in no particular order
+		*/
+		template< typename Fn >
+		void eachConsumable( Fn fn ) const
+		{
+			for ( const auto &it : _consumables ) {
+				fn( _topology.getCell( it.first ), it.second.size );
+			}
+		}
 		
-		crimild::Vector3f gridPosToWorld( const crimild::Vector2i gridPos ) const;
+		inline crimild::Vector3f gridPosToWorld( const crimild::Vector2i gridPos ) const
+		{
+			auto r = _rowRadius[ gridPos.y() ];
+			return crimild::Vector3f( r * _columnCos[ gridPos.x() ], _rowHeight[ gridPos.y() ], r * _columnSin[ gridPos.x() ] );
+		}
+
+		/**
+		   \brief Converts count grid positions to world positions in a single pass
+		*/
+		void gridPosToWorld( const crimild::Vector2i *gridPos, crimild::Vector3f *worldPos, crimild::Size count ) const;
+
+		/**
+		   \brief Writes occupancy, consumables and random counters
+
+		   The free cell index is rebuilt on restore.
+		*/
+		void save( Snapshot &snapshot ) const;
+
+		/**
+		   \brief Restores a state written by save() for a grid of the same size
+
+		   Restored consumables have no nodes. See
+		   GridSpawner::syncConsumables(). Returns false if the size
+		   doesn't match or the snapshot is truncated, in which case the
+		   grid is left untouched.
+		*/
+		crimild::Bool restore( Snapshot &snapshot );
 		
 	private:
-		void spawnPlayer( void );
-		void spawnConsumable( crimild::Bool startComponents = true );
-		
+		void setFree( crimild::Int32 word, crimild::Int32 bit, crimild::Bool free );
+		void rebuildFreeIndex( void );
+		BitGrid::Word getValidBits( crimild::Int32 word ) const;
+		void computeWorldTables( void );
+
 	private:
 		crimild::Int32 _width;
 		crimild::Int32 _height;
-		crimild::containers::Array< crimild::Bool > _state;
+		GridTopology _topology;
+		RandomStreams _random;
+		crimild::Bool _sparse;
+		BitGrid _occupied;
+
+		/**
+		   Only allocated for sparse grids. _occupied is empty then
+		*/
+		std::unique_ptr< SparseBitGrid > _sparseOccupied;
+		std::unordered_map< crimild::Int64, Pickup > _consumables;
+
+		/**
+		   A set bit in _blocked means the cell is occupied or holds a
+		   consumable. _wordFree counts the free cells of each word and
+		   _blockFree the free cells of each FREE_BLOCK_WORDS words, so
+		   the n-th free cell is found without visiting every cell and
+		   updating a cell touches three counters. That's a little over
+		   one bit per cell. Sparse grids leave all of them empty.
+		*/
+		static constexpr crimild::Int32 FREE_BLOCK_WORDS = 64;
+
+		BitGrid _blocked;
+		std::vector< crimild::UInt8 > _wordFree;
+		std::vector< crimild::Int32 > _blockFree;
+		crimild::Size _freeCount = 0;
+
+		/**
+		   The grid is mapped onto a cone. Columns give the angle around
+		   the axis (cos u, -sin u) and rows give the radius and height,
+		   so a world position only needs two multiplications.
+		*/
+		std::vector< crimild::Real32 > _columnCos;
+		std::vector< crimild::Real32 > _columnSin;
+		std::vector< crimild::Real32 > _rowRadius;
+		std::vector< crimild::Real32 > _rowHeight;
+
+		std::unique_ptr< messaging::GameEvents > _events;
 	};
 	
 }
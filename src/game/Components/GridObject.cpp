@@ -35,10 +35,17 @@ using namespace crimild;
 GridObject::GridObject( Grid *grid )
 	: _grid( grid )
 {
-	auto x = Random::generate< crimild::Int32 >( _grid->getWidth() );
-	auto y = Random::generate< crimild::Int32 >( _grid->getHeight() );
-	
-	_gridPos = Vector2i( x, y );
+	if ( !_grid->sampleFreeCell( _gridPos ) ) {
+		Log::warning( CRIMILD_CURRENT_CLASS_NAME, "No free cells left in grid" );
+		_gridPos = Vector2i( 0, 0 );
+	}
+}
+
+GridObject::GridObject( Grid *grid, const Vector2i &pos )
+	: _grid( grid ),
+	  _gridPos( pos )
+{
+
 }
 
 GridObject::~GridObject( void )
@@ -39,7 +39,11 @@ namespace hunger {
 		CRIMILD_IMPLEMENT_RTTI( hunger::GridObject )
 
 	public:
+		/**
+		   \brief Places the object on a random free cell
+		*/
 		explicit GridObject( Grid *grid );
+		GridObject( Grid *grid, const crimild::Vector2i &pos );
 		virtual ~GridObject( void );
 
 		Grid *getGrid( void ) { return _grid; }
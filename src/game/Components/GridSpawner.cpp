@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "GridSpawner.hpp"
+#include "Grid.hpp"
+#include "GridObject.hpp"
+#include "Consumable.hpp"
+#include "Player.hpp"
+
+#include "Messaging/GameEvents.hpp"
+
+#include <utility>
+
+using namespace hunger;
+using namespace hunger::messaging;
+
+using namespace crimild;
+
+GridSpawner::GridSpawner( void )
+{
+
+}
+
+GridSpawner::~GridSpawner( void )
+{
+
+}
+
+Grid *GridSpawner::getGrid( void )
+{
+	return getComponent< Grid >();
+}
+
+void GridSpawner::onAttach( void )
+{
+	spawnPlayer();
+	for ( crimild::Int32 i = 0; i < 5; i++ ) {
+		spawnConsumable();
+	}
+}
+
+void GridSpawner::start( void )
+{
+	getGrid()->getEvents().pickup.subscribe< GridSpawner, &GridSpawner::onPickup >( this );
+}
+
+void GridSpawner::spawnConsumable( void )
+{
+	Vector2i pos;
+	auto size = getGrid()->spawnConsumable( pos );
+	if ( size > 0 ) {
+		attachConsumable( pos, size );
+	}
+}
+
+void GridSpawner::syncConsumables( void )
+{
+	_pool.clear();
+	for ( auto consumable : _consumables ) {
+		recycleConsumable( consumable );
+	}
+
+	std::vector< std::pair< Vector2i, crimild::Int32 > > cells;
+	getGrid()->eachConsumable( [ &cells ]( const Vector2i &cell, crimild::Int32 size ) {
+		cells.push_back( std::make_pair( cell, size ) );
+	});
+
+	for ( const auto &cell : cells ) {
+		attachConsumable( cell.first, cell.second );
+	}
+}
+
+void GridSpawner::onPickup( const PickupEvent &event )
+{
+	if ( event.consumable != nullptr ) {
+		recycleConsumable( event.consumable );
+	}
+
+	// Respawn in the same step as the pickup, so the new position
+	// depends on the step and not on the frame rate. That's what
+	// makes replays reproducible. Every pickup recycles its node, so
+	// the pool is only empty if a node was lost. In that case the
+	// consumable is registered now and gets a new node at the end of
+	// the frame, since the scene can't change during an update.
+	if ( !_pool.empty() ) {
+		spawnConsumable();
+	}
+	else {
+		Vector2i pos;
+		getGrid()->spawnConsumable( pos );
+		crimild::concurrency::sync_frame( [ this ] {
+			syncConsumables();
+		});
+	}
+}
+
+void GridSpawner::spawnPlayer( void )
+{
+	auto player = crimild::alloc< Group >();
+	player->attachComponent< GridObject >( getGrid() );
+	player->attachComponent< Player >();
+
+	auto parent = getNode< Group >();
+	parent->attachNode( player );
+}
+
+void GridSpawner::attachConsumable( const Vector2i &pos, crimild::Int32 size )
+{
+	Consumable *consumable = nullptr;
+	if ( !_pool.empty() ) {
+		consumable = _pool.back();
+		_pool.pop_back();
+	}
+	else {
+		consumable = createConsumable( pos );
+	}
+
+	consumable->place( pos, size );
+	getGrid()->addConsumable( pos, size, consumable );
+}
+
+Consumable *GridSpawner::createConsumable( const Vector2i &pos )
+{
+	auto node = crimild::alloc< Group >();
+	node->attachComponent< GridObject >( getGrid(), pos );
+	node->attachComponent< Consumable >();
+
+	auto parent = getNode< Group >();
+	parent->attachNode( node );
+	node->perform( UpdateRenderState() );
+	node->perform( UpdateWorldState() );
+	node->startComponents();
+
+	auto consumable = node->getComponent< Consumable >();
+	_consumables.push_back( consumable );
+	return consumable;
+}
+
+void GridSpawner::recycleConsumable( Consumable *consumable )
+{
+	consumable->getNode()->setEnabled( false );
+	_pool.push_back( consumable );
+}
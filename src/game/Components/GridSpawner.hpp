@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_COMPONENTS_GRID_SPAWNER_
+#define HUNGER_COMPONENTS_GRID_SPAWNER_
+
+#include <Crimild.hpp>
+
+#include <vector>
+
+namespace hunger {
+
+	class Grid;
+	class Consumable;
+
+	namespace messaging {
+
+		struct PickupEvent;
+
+	}
+
+	/**
+	   \brief Creates the player and consumable nodes of the Grid in the same node
+
+	   The grid only keeps the game state. This component gives
+	   each registered consumable a node, and respawns consumables
+	   when they're picked up.
+	*/
+	class GridSpawner : public crimild::NodeComponent {
+		CRIMILD_IMPLEMENT_RTTI( hunger::GridSpawner )
+
+	public:
+		GridSpawner( void );
+		virtual ~GridSpawner( void );
+
+		virtual void onAttach( void ) override;
+		virtual void start( void ) override;
+
+		/**
+		   \brief Spawns a consumable on a random free cell, with its node
+		*/
+		void spawnConsumable( void );
+
+		/**
+		   \brief Gives a node to every consumable registered in the grid
+
+		   Must be called after the grid is restored. All nodes are
+		   recycled first, and new ones are only created if there are
+		   more consumables than nodes.
+		*/
+		void syncConsumables( void );
+
+	private:
+		Grid *getGrid( void );
+
+		void onPickup( const messaging::PickupEvent &event );
+
+		void spawnPlayer( void );
+		void attachConsumable( const crimild::Vector2i &pos, crimild::Int32 size );
+		Consumable *createConsumable( const crimild::Vector2i &pos );
+		void recycleConsumable( Consumable *consumable );
+
+	private:
+		/**
+		   Consumed nodes stay attached but disabled, and are reused
+		   instead of allocating a new hierarchy.
+		*/
+		std::vector< Consumable * > _consumables;
+		std::vector< Consumable * > _pool;
+	};
+
+}
+
+#endif
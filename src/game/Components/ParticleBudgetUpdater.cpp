@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ParticleBudgetUpdater.hpp"
+
+#include <algorithm>
+
+using namespace hunger;
+
+using namespace crimild;
+
+ParticleBudgetUpdater::ParticleBudgetUpdater( ParticleSystemComponent *system, const ParticleBudget &budget )
+	: _system( system ),
+	  _budget( budget )
+{
+
+}
+
+ParticleBudgetUpdater::~ParticleBudgetUpdater( void )
+{
+
+}
+
+void ParticleBudgetUpdater::configure( Node *node, ParticleData *particles )
+{
+	_times = particles->createAttribArray< crimild::Real32 >( ParticleAttrib::TIME );
+	_lifetimes = particles->createAttribArray< crimild::Real32 >( ParticleAttrib::LIFE_TIME );
+	_order.reserve( _budget.getPoolSize() );
+}
+
+void ParticleBudgetUpdater::update( Node *node, crimild::Real64 dt, ParticleData *particles )
+{
+	_system->setEmitRate( _budget.update( dt ) );
+
+	auto count = _budget.computeCullCount( particles->getAliveCount(), dt );
+	if ( count > 0 ) {
+		cull( particles, count );
+	}
+}
+
+void ParticleBudgetUpdater::cull( ParticleData *particles, crimild::Size count )
+{
+	auto times = _times->getData< crimild::Real32 >();
+	auto lifetimes = _lifetimes->getData< crimild::Real32 >();
+	auto alive = particles->getAliveCount();
+
+	_order.resize( alive );
+	for ( crimild::Size i = 0; i < alive; i++ ) {
+		_order[ i ] = i;
+	}
+
+	// the oldest particles have used most of their lifetime
+	auto age = [ times, lifetimes ]( ParticleId i ) {
+		return lifetimes[ i ] - times[ i ];
+	};
+	std::nth_element( _order.begin(), _order.begin() + ( count - 1 ), _order.end(), [ &age ]( ParticleId a, ParticleId b ) {
+		return age( a ) > age( b );
+	});
+
+	// expire them, and let the time updater remove them
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		times[ _order[ i ] ] = 0.0f;
+	}
+}
+
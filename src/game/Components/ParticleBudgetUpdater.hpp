@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_COMPONENTS_PARTICLE_BUDGET_UPDATER_
+#define HUNGER_COMPONENTS_PARTICLE_BUDGET_UPDATER_
+
+#include "Logic/ParticleBudget.hpp"
+
+#include <Crimild.hpp>
+
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Keeps a particle system within its budget
+
+	   Adjusts the emit rate every frame and, when the pool is about
+	   to fill up, expires the oldest particles so new ones can still
+	   be emitted. Must run before the TimeParticleUpdater, which is
+	   the one that actually removes expired particles.
+	*/
+	class ParticleBudgetUpdater : public crimild::ParticleSystemComponent::ParticleUpdater {
+		CRIMILD_IMPLEMENT_RTTI( hunger::ParticleBudgetUpdater )
+
+	public:
+		/**
+		   \param system The system whose emit rate is adjusted. Not owned
+		*/
+		ParticleBudgetUpdater( crimild::ParticleSystemComponent *system, const ParticleBudget &budget );
+		virtual ~ParticleBudgetUpdater( void );
+
+		const ParticleBudget &getBudget( void ) const { return _budget; }
+
+		virtual void configure( crimild::Node *node, crimild::ParticleData *particles ) override;
+		virtual void update( crimild::Node *node, crimild::Real64 dt, crimild::ParticleData *particles ) override;
+
+	private:
+		void cull( crimild::ParticleData *particles, crimild::Size count );
+
+	private:
+		crimild::ParticleSystemComponent *_system = nullptr;
+		ParticleBudget _budget;
+
+		crimild::ParticleAttribArray *_times = nullptr;
+		crimild::ParticleAttribArray *_lifetimes = nullptr;
+
+		std::vector< crimild::ParticleId > _order;
+	};
+
+}
+
+#endif
+
@@ -28,9 +28,18 @@
 #include "Player.hpp"
 #include "Grid.hpp"
 #include "GridObject.hpp"
+#include "GridSpawner.hpp"
 #include "Consumable.hpp"
+#include "ProfilerOverlay.hpp"
+#include "ParticleBudgetUpdater.hpp"
+
+#include "Logic/World.hpp"
+#include "Logic/Profiler.hpp"
+
+#include "Rendering/StreamingVertexBufferObjectCatalog.hpp"
 
 #include "Messaging/Messages.hpp"
+#include "Messaging/GameEvents.hpp"
 
 using namespace hunger;
 using namespace hunger::messaging;
@@ -38,6 +47,8 @@ using namespace hunger::messaging;
 using namespace crimild;
 using namespace crimild::messaging;
 
+constexpr crimild::Size TrailPositionParticleGenerator::BATCH_SIZE;
+
 TrailPositionParticleGenerator::TrailPositionParticleGenerator( void )
 {
 
@@ -56,28 +67,73 @@ void TrailPositionParticleGenerator::configure( Node *node, ParticleData *partic
 
 void TrailPositionParticleGenerator::generate( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId startId, ParticleId endId )
 {
+	assert( _random != nullptr );
+
 	auto ps = _positions->getData< Vector3f >();
-	
-    for ( ParticleId i = startId; i < endId; i++ ) {
-		auto idx = Random::generate< crimild::Real32 >( _trail.size() );
-		auto lo = crimild::Int32( idx );
-		auto hi = crimild::Int32( idx ) + 1;
-		auto p = _trail[ lo ];
-		if ( hi < _trail.size() ) {
-			auto x = idx - lo / ( hi - lo );
-			Vector3f dir = _trail[ hi ] - _trail[ lo ];
-			dir.normalize();
-			p += x * dir;
+	auto worldSpace = particles->shouldComputeInWorldSpace();
+
+	const auto &trail = _trail;
+	if ( trail.segmentCount == 0 || trail.length <= 0.0f ) {
+		// nothing to sample from. Player disables the particle system
+		// while its trail is empty, so this only happens if used elsewhere
+		for ( ParticleId i = startId; i < endId; i++ ) {
+			ps[ i ] = Vector3f::ZERO;
+			if ( worldSpace ) {
+				node->getWorld().applyToPoint( ps[ i ], ps[ i ] );
+			}
+		}
+		return;
+	}
+
+	crimild::Real32 s[ BATCH_SIZE ];
+	crimild::UInt32 segment[ BATCH_SIZE ];
+	crimild::Real32 x[ BATCH_SIZE ];
+	crimild::Real32 y[ BATCH_SIZE ];
+	crimild::Real32 z[ BATCH_SIZE ];
+
+	for ( ParticleId first = startId; first < endId; first += BATCH_SIZE ) {
+		const auto count = std::min< crimild::Size >( BATCH_SIZE, endId - first );
+
+		// arc length of each particle along the trail
+		_random->generate( s, count, trail.start[ 0 ], trail.start[ 0 ] + trail.length );
+
+		// last segment starting at or before s. The number of iterations
+		// only depends on the segment count, so all lanes run in lockstep
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			segment[ i ] = 0;
+		}
+		for ( auto n = trail.segmentCount; n > 1; ) {
+			const auto half = n / 2;
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				auto probe = segment[ i ] + half;
+				segment[ i ] = trail.start[ probe ] <= s[ i ] ? probe : segment[ i ];
+			}
+			n -= half;
 		}
-		if ( particles->shouldComputeInWorldSpace() ) {
-			node->getWorld().applyToPoint( p, p );
+
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			auto k = segment[ i ];
+			auto t = s[ i ] - trail.start[ k ];
+			x[ i ] = trail.originX[ k ] + t * trail.directionX[ k ];
+			y[ i ] = trail.originY[ k ] + t * trail.directionY[ k ];
+			z[ i ] = trail.originZ[ k ] + t * trail.directionZ[ k ];
 		}
-		ps[ i ] = p;
-    }
+
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			auto &p = ps[ first + i ];
+			p = Vector3f( x[ i ], y[ i ], z[ i ] );
+			if ( worldSpace ) {
+				node->getWorld().applyToPoint( p, p );
+			}
+		}
+	}
 }
 
 
+constexpr crimild::Size Player::TURN_QUEUE_SIZE;
+
 Player::Player( void )
+	: _turnQueue( TURN_QUEUE_SIZE )
 {
 	
 }
@@ -91,16 +147,12 @@ void Player::onAttach( void )
 {
 	auto parent = getNode< Group >();
 	
-	const auto TAIL_SIZE = 500;
-	
-	for ( crimild::Size i = 0; i < TAIL_SIZE; i++ ) {
-		auto n = crimild::alloc< Node >();
-		n->local().setTranslate( Vector3f::POSITIVE_INFINITY );
-		parent->attachNode( n );
-		_tail.push( TailNode { Vector2i( -1, -1 ), crimild::get_ptr( n ) } );
-	}
+	// only the head needs a node. The tail lives in the snake
+	auto head = crimild::alloc< Node >();
+	head->local().setTranslate( Vector3f::POSITIVE_INFINITY );
+	parent->attachNode( head );
+	_head = crimild::get_ptr( head );
 
-	/*
 	auto g = crimild::alloc< Geometry >();
 	auto m = crimild::alloc< Material >();
 	m->setProgram( Renderer::getInstance()->getShaderProgram( Renderer::SHADER_PROGRAM_UNLIT_DIFFUSE ) );
@@ -108,21 +160,29 @@ void Player::onAttach( void )
 	g->getComponent< MaterialComponent >()->attachMaterial( m );
 	parent->attachNode( g );
 	_renderer = crimild::get_ptr( g );
-	*/
 
 
+	// "particles_max=<n>" caps the pool and "particles_frame_ms=<ms>"
+	// is the frame time above which emission is scaled down
+	ParticleBudget::Config budget;
+	budget.emitRate = 100.0f;
+	budget.maxLifetime = 200.0f;
+	auto settings = Simulation::getInstance()->getSettings();
+	budget.maxParticles = std::strtoul( settings->get< std::string >( "particles_max", "5000" ).c_str(), nullptr, 10 );
+	budget.frameBudget = 0.001f * std::strtof( settings->get< std::string >( "particles_frame_ms", "20" ).c_str(), nullptr );
+
 	auto particleSystem = crimild::alloc< Group >();
-	auto particles = crimild::alloc< ParticleData >( 5000 );
+	auto particles = crimild::alloc< ParticleData >( ParticleBudget( budget ).getPoolSize() );
 	particles->setComputeInWorldSpace( false );
 	auto ps = crimild::alloc< ParticleSystemComponent >( particles );
-	ps->setEmitRate( 100 );
+	ps->setEmitRate( budget.emitRate );
 	// generators
+	ps->addGenerator( crimild::alloc< ProfilerParticleGenerator >( true ) );
 	//auto posGenerator = crimild::alloc< BoxPositionParticleGenerator >();
 	//posGenerator->setOrigin( Vector3f::ZERO );
 	//posGenerator->setSize( Vector3f::ONE );
-	auto posGenerator = crimild::alloc< NodePositionParticleGenerator >();
-	posGenerator->setTargetNode( getNode() );
-	_posGenerator = crimild::get_ptr( posGenerator );
+	auto posGenerator = crimild::alloc< TrailPositionParticleGenerator >();
+	_trailGenerator = crimild::get_ptr( posGenerator );
 	ps->addGenerator( posGenerator );
 	/*
 	auto velocityGenerator = crimild::alloc< RandomVector3fParticleGenerator >();
@@ -148,11 +208,15 @@ void Player::onAttach( void )
 	ps->addGenerator( scaleGenerator );
 	auto timeGenerator = crimild::alloc< TimeParticleGenerator >();
 	timeGenerator->setMinTime( 120.0f );
-	timeGenerator->setMaxTime( 200.0f );
+	timeGenerator->setMaxTime( budget.maxLifetime );
 	ps->addGenerator( timeGenerator );
+	ps->addGenerator( crimild::alloc< ProfilerParticleGenerator >( false ) );
 	// updaters
+	ps->addUpdater( crimild::alloc< ProfilerParticleUpdater >( true ) );
+	ps->addUpdater( crimild::alloc< ParticleBudgetUpdater >( crimild::get_ptr( ps ), ParticleBudget( budget ) ) );
 	//ps->addUpdater( crimild::alloc< EulerParticleUpdater >() );
 	ps->addUpdater( crimild::alloc< TimeParticleUpdater >() );
+	ps->addUpdater( crimild::alloc< ProfilerParticleUpdater >( false ) );
 	// renderers
     auto renderer = crimild::alloc< PointSpriteParticleRenderer >();
 	renderer->getMaterial()->getCullFaceState()->setEnabled( false );
@@ -160,185 +224,423 @@ void Player::onAttach( void )
 
 	particleSystem->attachComponent( ps );
 	parent->attachNode( particleSystem );
+	_particleSystem = crimild::get_ptr( ps );
+	updateTrailView();
 }
 
 void Player::start( void )
 {
-	_speed = 10.0f;
+	auto gridObject = getComponent< GridObject >();
+	auto grid = gridObject->getGrid();
+
+	auto d = static_cast< Snake::Direction >( grid->getRandom().gameplay.generate( 4 ) );
+	_snake.reset( gridObject->getPosition(), d );
+	createTrail( _snake.getTailLength() );
+
+	_trailGenerator->setRandom( &grid->getRandom().particles );
+
+	_recording = Replay( grid->getRandom().seed, grid->getWidth(), grid->getHeight(), grid->getConsumableCount() );
+	_replayCursor = 0;
 	
-	auto d = Random::generate< crimild::Int32 >( 4 );
-	switch ( d ) {
-		case 0:
-			_direction = Direction::UP;
-			break;
-			
-		case 1:
-			_direction = Direction::DOWN;
-			break;
-			
-		case 2:
-			_direction = Direction::LEFT;
-			break;
-			
-		case 3:
-			_direction = Direction::RIGHT;
-			break;
+	auto maxSteps = Simulation::getInstance()->getSettings()->get< std::string >( "max_catchup_steps", "5" );
+	_scheduler.setMaxStepsPerFrame( std::strtoul( maxSteps.c_str(), nullptr, 10 ) );
+	_scheduler.reset();
+
+	_turnQueue.clear();
+	_leftDown = false;
+	_rightDown = false;
+
+	if ( Simulation::getInstance()->getSettings()->get< std::string >( "autoplay", "0" ) == "1" ) {
+		if ( grid->isSparse() ) {
+			// its bitboards cover the whole grid
+			Log::warning( CRIMILD_CURRENT_CLASS_NAME, "The autoplayer needs a dense grid. Autoplay disabled" );
+		}
+		else {
+			_autoPlayer.reset( new AutoPlayer( grid->getWidth(), grid->getHeight() ) );
+		}
 	}
-	
-	registerMessageHandler< KeyReleased >( [ this ]( KeyReleased const &m ) {
+
+	// turn as soon as a key goes down. Auto-repeat is ignored
+	registerMessageHandler< KeyPressed >( [ this ]( KeyPressed const &m ) {
+		if ( isReplaying() ) {
+			return;
+		}
+
 		if ( m.key == CRIMILD_INPUT_KEY_LEFT ) {
-			switch ( _direction ) {
-				case Direction::UP:
-					_direction = Direction::LEFT;
-					break;
-					
-				case Direction::DOWN:
-					_direction = Direction::RIGHT;
-					break;
-					
-				case Direction::LEFT:
-					_direction = Direction::DOWN;
-					break;
-					
-				case Direction::RIGHT:
-					_direction = Direction::UP;
-					break;
+			if ( !_leftDown ) {
+				queueTurn( Snake::Turn::LEFT );
 			}
+			_leftDown = true;
 		}
 		else if ( m.key == CRIMILD_INPUT_KEY_RIGHT ) {
-			switch ( _direction ) {
-				case Direction::UP:
-					_direction = Direction::RIGHT;
-					break;
-					
-				case Direction::DOWN:
-					_direction = Direction::LEFT;
-					break;
-					
-				case Direction::LEFT:
-					_direction = Direction::UP;
-					break;
-					
-				case Direction::RIGHT:
-					_direction = Direction::DOWN;
-					break;
+			if ( !_rightDown ) {
+				queueTurn( Snake::Turn::RIGHT );
 			}
+			_rightDown = true;
 		}
 	});
 
-	registerMessageHandler< ConsumableDestroyed >( [ this ]( ConsumableDestroyed const &m ) {
-		
+	registerMessageHandler< KeyReleased >( [ this ]( KeyReleased const &m ) {
+		if ( m.key == CRIMILD_INPUT_KEY_LEFT ) {
+			_leftDown = false;
+		}
+		else if ( m.key == CRIMILD_INPUT_KEY_RIGHT ) {
+			_rightDown = false;
+		}
 	});
 }
 
+void Player::setReplay( SharedPointer< Replay > const &replay, crimild::UInt64 fastForwardUntil )
+{
+	_replay = replay;
+	_replayCursor = 0;
+	_fastForwardUntil = fastForwardUntil;
+}
+
+void Player::save( Snapshot &snapshot ) const
+{
+	auto grid = getComponent< GridObject >()->getGrid();
+	grid->save( snapshot );
+	_snake.save( snapshot );
+}
+
+crimild::Bool Player::restore( Snapshot &snapshot )
+{
+	auto gridObject = getComponent< GridObject >();
+	auto grid = gridObject->getGrid();
+
+	// the grid is read first, so keep it in case the snake is invalid
+	Snapshot previous;
+	grid->save( previous );
+
+	if ( !grid->restore( snapshot ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot restore snapshot" );
+		return false;
+	}
+
+	auto restored = _snake.restore( snapshot, grid );
+	if ( !restored ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot restore snapshot" );
+		grid->restore( previous );
+	}
+
+	// restored consumables have no nodes yet
+	grid->getComponent< GridSpawner >()->syncConsumables();
+
+	if ( !restored ) {
+		return false;
+	}
+
+	resume();
+	return true;
+}
+
+crimild::Bool Player::restart( crimild::UInt64 seed )
+{
+	auto grid = getComponent< GridObject >()->getGrid();
+
+	// starts exactly like a new world or scene with the same seed
+	auto consumableCount = grid->getConsumableCount();
+	grid->reset( seed );
+	World::populate( grid, _snake, consumableCount );
+	grid->getComponent< GridSpawner >()->syncConsumables();
+
+	resume();
+	return true;
+}
+
+void Player::resume( void )
+{
+	auto gridObject = getComponent< GridObject >();
+	auto grid = gridObject->getGrid();
+
+	gridObject->setPosition( _snake.getPosition() );
+	if ( !_snake.getTail().empty() ) {
+		_headFrom = _headTo = _snake.getTail().back().worldPos;
+		updateHead( 1.0f );
+	}
+	else {
+		_head->local().setTranslate( Vector3f::POSITIVE_INFINITY );
+	}
+	// sized for the current tail. It grows with the snake
+	createTrail( _snake.getTail().size() );
+
+	_scheduler.reset();
+	_turnQueue.clear();
+	_recording = Replay( grid->getRandom().seed, grid->getWidth(), grid->getHeight(), grid->getConsumableCount() );
+	_replay = nullptr;
+	_replayCursor = 0;
+	_fastForwardUntil = 0;
+
+	setEnabled( true );
+	broadcastMessage( GameRestarted { } );
+}
+
 void Player::update( const Clock &c )
 {
-	if ( c.getDeltaTime() > 1.0f ) {
+	Profiler::Scope scope( Profiler::PHASE_UPDATE );
+
+	if ( _snake.getStepCount() < _fastForwardUntil ) {
+		// Simulate without waiting for the clock. Long replays are
+		// spread over several frames to keep the window responsive.
+		const crimild::Size MAX_STEPS_PER_FRAME = 100000;
+		for ( crimild::Size i = 0; i < MAX_STEPS_PER_FRAME && _snake.getStepCount() < _fastForwardUntil; i++ ) {
+			if ( !step() ) {
+				gameOver();
+				return;
+			}
+		}
+		_scheduler.reset();
+		updateHead( 1.0f );
+		renderTail();
+		return;
+	}
+
+	if ( _scheduler.isPause( c.getDeltaTime() ) ) {
 		return;
 	}
 	
-	if ( _speed < 60.0f ) {
-		_speed += 0.1f * c.getDeltaTime();
+	auto speed = _snake.getSpeed();
+	if ( speed < 60.0f ) {
+		speed += 0.1f * c.getDeltaTime();
+		_snake.setSpeed( speed );
 	}
 	
-	const auto FIXED_TIME = 1.0f / _speed;
+	const auto FIXED_TIME = 1.0f / speed;
 	
-	_t += c.getDeltaTime();
-	while ( _t >= FIXED_TIME ) {
+	auto steps = _scheduler.advance( c.getDeltaTime(), FIXED_TIME );
+	for ( crimild::Size i = 0; i < steps; i++ ) {
 		if ( !step() ) {
-			broadcastMessage( GameOver { } );
-			setEnabled( false );
+			gameOver();
 			return;
 		}
-		_t -= FIXED_TIME;
 	}
 
+	updateHead( _scheduler.getAlpha( FIXED_TIME ) );
 	renderTail();
 }
 
+void Player::updateHead( crimild::Real32 alpha )
+{
+	if ( _snake.getTail().empty() ) {
+		// not moved yet
+		return;
+	}
+
+	_head->local().setTranslate( _headFrom + alpha * ( _headTo - _headFrom ) );
+}
+
+void Player::turn( Snake::Turn turn )
+{
+	_snake.turn( turn );
+	_recording.record( _snake.getStepCount(), turn );
+}
+
+void Player::queueTurn( Snake::Turn turn )
+{
+	if ( _turnQueue.full() ) {
+		Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Turn queue is full. Dropping turn" );
+		return;
+	}
+
+	_turnQueue.push( QueuedTurn { turn, std::chrono::steady_clock::now() } );
+}
+
+void Player::gameOver( void )
+{
+	broadcastMessage( GameOver { } );
+	setEnabled( false );
+}
+
 crimild::Bool Player::step( void )
 {
+	Profiler::Scope scope( Profiler::PHASE_STEP );
+
 	auto gridObject = getComponent< GridObject >();
 	auto grid = gridObject->getGrid();
-	auto gridPos = gridObject->getPosition();
-	auto prevPos = gridPos;
-
-	const crimild::Int32 SPEED = 1;
-	switch ( _direction ) {
-		case Direction::UP:
-			gridPos.y() -= 1;
-			break;
-			
-		case Direction::DOWN:
-			gridPos.y() += 1;
-			break;
-			
-		case Direction::LEFT:
-			gridPos.x() -= 1;
-			break;
-			
-		case Direction::RIGHT:
-			gridPos.x() += 1;
-			break;
+
+	if ( _replay != nullptr ) {
+		_replayCursor = _replay->play( _replayCursor, _snake.getStepCount(), [ this ]( Snake::Turn t ) {
+			turn( t );
+		});
 	}
-	
-	if ( !grid->move( gridPos ) ) {
+
+	if ( !_turnQueue.empty() ) {
+		// recorded with the step it's applied on, so replays match
+		auto queued = _turnQueue.pop();
+		turn( queued.turn );
+		if ( auto profiler = Profiler::getInstance() ) {
+			profiler->recordInputLatency( std::chrono::steady_clock::now() - queued.time );
+		}
+	}
+	else if ( _autoPlayer != nullptr && !isReplaying() ) {
+		auto move = _autoPlayer->decide( grid, _snake );
+		if ( move != AutoPlayer::Move::STRAIGHT ) {
+			turn( move == AutoPlayer::Move::LEFT ? Snake::Turn::LEFT : Snake::Turn::RIGHT );
+		}
+	}
+
+	auto prevPos = _snake.getPosition();
+
+	auto &events = grid->getEvents();
+
+	Grid::Pickup pickup;
+	if ( !_snake.step( grid, &pickup ) ) {
 		Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Game Over!" );
 		return false;
 	}
 
+	const auto &gridPos = _snake.getPosition();
+
+	if ( pickup.size > 0 ) {
+		events.pickup.push( PickupEvent { gridPos, pickup.size, pickup.consumable, _snake.getStepCount() } );
+	}
+
+	// delivered before the next step, so a respawn is visible to it
+	events.flush();
+
 	gridObject->setPosition( gridPos );
-	auto worldPos = grid->gridPosToWorld( gridPos );
 
-	auto t = _tail.pop();
-	if ( t.pos.x() >= 0 && t.pos.y() >= 0 ) {
-		grid->setEmpty( t.pos, true );
+	auto worldPos = _snake.getTail().back().worldPos;
+
+	// don't draw a segment (or move the head) across the grid when wrapping around
+	auto d = gridPos - prevPos;
+	if ( std::abs( d.x() ) + std::abs( d.y() ) == 1 ) {
+		_headFrom = grid->gridPosToWorld( prevPos );
+		pushTrailSegment( _headFrom, worldPos );
 	}
-	t.pos = gridPos;
-	t.node->local().setTranslate( worldPos );
-	_head = t.node;
-	_tail.push( t );
+	else {
+		_headFrom = worldPos;
+		pushTrailSegment( worldPos, worldPos );
+	}
+	_headTo = worldPos;
 	
 	return true;
 }
 
-void Player::renderTail( void )
+void Player::createTrail( crimild::Size capacity )
 {
-	_posGenerator->setTargetNode( getNode() );
-	if ( getHead() != nullptr ) {
-		_posGenerator->setTargetNode( getHead() );
-	}
-	
-	if ( _tail.empty() ) {
+	if ( _renderer == nullptr ) {
 		return;
 	}
 
-#if 0
-	//const auto VERTEX_COUNT = _tail.size() * 2;
-	containers::Array< Vector3f > trail;
-	//auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3, VERTEX_COUNT );
-	//auto ibo = crimild::alloc< IndexBufferObject >( VERTEX_COUNT );
-	//auto prevPos = _tail.front().node->getLocal().getTranslate();
-	_tail.each( [ this, /*ibo, vbo, &prevPos,*/ &trail ]( TailNode &t, crimild::Size i ) {
-		if ( t.pos.x() >= 0 && t.pos.y() >= 0 ) {
-			auto pos = t.node->getLocal().getTranslate();
-			trail.add( pos );
-			//vbo->setPositionAt( i * 2 + 0, prevPos );
-			//vbo->setPositionAt( i * 2 + 1, pos );
-			//prevPos = pos;
-			//ibo->setIndexAt( i * 2 + 0, i * 2 + 0 );
-			//ibo->setIndexAt( i * 2 + 1, i * 2 + 1 );
+	auto grid = getComponent< GridObject >()->getGrid();
+
+	_trailCapacity = std::max< crimild::Size >( capacity, 1 );
+	_trailNext = 0;
+	_trailCount = 0;
+
+	const auto VERTEX_COUNT = _trailCapacity * 2;
+	auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3, VERTEX_COUNT );
+	auto ibo = crimild::alloc< IndexBufferObject >( VERTEX_COUNT );
+	for ( crimild::Size i = 0; i < VERTEX_COUNT; i++ ) {
+		vbo->setPositionAt( i, Vector3f::ZERO );
+		ibo->setIndexAt( i, i );
+	}
+	_trailVBO = crimild::get_ptr( vbo );
+	_trailCatalog = nullptr;
+	_trailPath.clear();
+
+	auto primitive = crimild::alloc< Primitive >( Primitive::Type::LINES );
+	primitive->setVertexBuffer( vbo );
+	primitive->setIndexBuffer( ibo );
+
+	_renderer->detachAllPrimitives();
+	_renderer->attachPrimitive( primitive );
+
+	// vertices start collapsed, so bound the whole cone instead
+	auto r = 0.5f * grid->getWidth();
+	auto h = crimild::Real32( grid->getHeight() );
+	_renderer->localBound()->computeFrom( Vector3f( -r, -0.5f * h, -r ), Vector3f( r, 0.25f * h, r ) );
+
+	// replay the current tail, if any
+	const auto &tail = _snake.getTail();
+	for ( crimild::Size i = 1; i < tail.size(); i++ ) {
+		auto d = tail[ i ].gridPos - tail[ i - 1 ].gridPos;
+		if ( std::abs( d.x() ) + std::abs( d.y() ) == 1 ) {
+			pushTrailSegment( tail[ i - 1 ].worldPos, tail[ i ].worldPos );
 		}
-	});
+		else {
+			pushTrailSegment( tail[ i ].worldPos, tail[ i ].worldPos );
+		}
+	}
+
+	updateTrailView();
+	_trailDirty = true;
+}
+
+void Player::pushTrailSegment( const Vector3f &from, const Vector3f &to )
+{
+	// n cells are joined by n - 1 segments
+	auto maxSegments = _snake.getTailLength() - 1;
+	if ( _trailCount == _trailCapacity && _trailCount < maxSegments ) {
+		// doubled, so the tail is replayed only a few times while it grows
+		createTrail( std::min( maxSegments, 2 * _trailCapacity ) );
+		return;
+	}
+
+	auto slot = _trailNext;
+	_trailVBO->setPositionAt( 2 * slot + 0, from );
+	_trailVBO->setPositionAt( 2 * slot + 1, to );
+	markTrailDirty( slot );
+	_trailPath.push( from, to );
+	_trailNext = ( slot + 1 ) % _trailCapacity;
+	++_trailCount;
+
+	while ( _trailCount > maxSegments ) {
+		// collapse the oldest segment into a point so it's not visible
+		auto oldest = ( _trailNext + _trailCapacity - _trailCount ) % _trailCapacity;
+		_trailVBO->setPositionAt( 2 * oldest + 0, to );
+		_trailVBO->setPositionAt( 2 * oldest + 1, to );
+		markTrailDirty( oldest );
+		_trailPath.pop();
+		--_trailCount;
+	}
+
+	updateTrailView();
+}
 
-	_posGenerator->setTrail( trail );	
+void Player::updateTrailView( void )
+{
+	if ( _trailGenerator == nullptr ) {
+		return;
+	}
+
+	// the path's arrays may have moved
+	_trailGenerator->setTrail( _trailPath.getView() );
+
+	// nothing to emit from until the snake has moved
+	_particleSystem->setEnabled( _trailPath.getLength() > 0.0f );
+}
+
+void Player::markTrailDirty( crimild::Size slot )
+{
+	if ( _trailCatalog == nullptr ) {
+		// null until the buffer is first loaded, which uploads all of it
+		_trailCatalog = dynamic_cast< StreamingVertexBufferObjectCatalog * >( _trailVBO->getCatalog() );
+	}
+
+	if ( _trailCatalog != nullptr ) {
+		// consecutive slots are merged into a single upload
+		_trailCatalog->markDirty( _trailVBO, 2 * slot, 2 );
+	}
+
+	_trailDirty = true;
+}
+
+void Player::renderTail( void )
+{
+	if ( !_trailDirty ) {
+		return;
+	}
 
-	//auto primitive = crimild::alloc< Primitive >( Primitive::Type::LINES );
-	//primitive->setVertexBuffer( vbo );
-	//primitive->setIndexBuffer( ibo );
+	if ( _trailCatalog == nullptr ) {
+		// loaded by a catalog that can't update part of a buffer
+		if ( auto catalog = _trailVBO->getCatalog() ) {
+			catalog->unload( _trailVBO );
+		}
+	}
 
-	//_renderer->detachAllPrimitives();
-	//_renderer->attachPrimitive( primitive );
-#endif
+	_trailDirty = false;
 }
 
@@ -28,28 +28,55 @@
 #ifndef HUNGER_COMPONENTS_PLAYER_
 #define HUNGER_COMPONENTS_PLAYER_
 
+#include "Logic/Snake.hpp"
+#include "Logic/RandomStream.hpp"
+#include "Logic/Replay.hpp"
+#include "Logic/TrailPath.hpp"
+#include "Logic/FixedStepScheduler.hpp"
+#include "Logic/AutoPlayer.hpp"
+
 #include <Crimild.hpp>
 
+#include <chrono>
+#include <memory>
+
 namespace crimild {
 
+	/**
+	   \brief Emits particles at uniformly distributed points along a trail
+
+	   Positions are computed in batches: random arc lengths are drawn
+	   together, then each lane finds its segment with a branchless
+	   binary search and interpolates along it. The loops have no
+	   branches or calls, so they vectorize when gathers are available.
+	*/
 	class TrailPositionParticleGenerator : public ParticleSystemComponent::ParticleGenerator {
 		CRIMILD_IMPLEMENT_RTTI( crimild::TrailPositionParticleGenerator )
 
-	private:
-		using Trail = containers::Array< Vector3f >;
-		
+	public:
+		static constexpr crimild::Size BATCH_SIZE = 64;
+
 	public:
 		TrailPositionParticleGenerator( void );
 		virtual ~TrailPositionParticleGenerator( void );
 
-		void setTrail( const Trail &trail ) { _trail = trail; }
-		const Trail &getTrail( void ) const { return _trail; }
+		/**
+		   \brief The trail to emit from. Borrowed, so it must outlive its use
+		*/
+		void setTrail( const hunger::TrailView &trail ) { _trail = trail; }
+		const hunger::TrailView &getTrail( void ) const { return _trail; }
+
+		/**
+		   \brief Stream used to sample positions along the trail. Not owned
+		*/
+		void setRandom( hunger::RandomStream *random ) { _random = random; }
 
 		virtual void configure( Node *node, ParticleData *particles ) override;
         virtual void generate( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId startId, ParticleId endId ) override;
 
 	private:
-		Trail _trail;
+		hunger::TrailView _trail;
+		hunger::RandomStream *_random = nullptr;
 		
 		ParticleAttribArray *_positions = nullptr;
 	};
@@ -58,6 +85,8 @@ namespace crimild {
 
 namespace hunger {
 
+	class StreamingVertexBufferObjectCatalog;
+
 	class Player :
 		public crimild::NodeComponent,
 		public crimild::DynamicSingleton< Player >,
@@ -74,36 +103,143 @@ namespace hunger {
 
 		crimild::Node *getHead( void ) { return _head; }
 
+		const Snake &getSnake( void ) const { return _snake; }
+
+		/**
+		   \brief Number of cells occupied by the snake. Defaults to 500
+		*/
+		void setTailLength( crimild::Size length ) { _snake.setTailLength( length ); }
+
+		/**
+		   \brief Turns made by the user in the current game, tagged with their step
+		*/
+		const Replay &getRecording( void ) const { return _recording; }
+
+		/**
+		   \brief Plays a recorded session instead of reading input
+
+		   Steps before fastForwardUntil are simulated as fast as
+		   possible, without waiting for the clock. After that the game
+		   continues at normal speed, and input is accepted again once
+		   all recorded turns have been played. The grid must have been
+		   created with the replay's seed.
+		*/
+		void setReplay( crimild::SharedPointer< Replay > const &replay, crimild::UInt64 fastForwardUntil = 0 );
+
+		crimild::Bool isReplaying( void ) const { return _replay != nullptr && _replayCursor < _replay->getEventCount(); }
+
+		/**
+		   \brief Writes the grid and the snake, in the same layout as World::save()
+		*/
+		void save( Snapshot &snapshot ) const;
+
+		/**
+		   \brief Resets the existing scene to a saved state
+
+		   Only grid cells, consumable transforms, the head and the
+		   trail buffer are updated, so this is much faster than
+		   building a new scene. Starts a new recording and broadcasts
+		   GameRestarted on success. On failure the grid and the snake
+		   are left as they were.
+		*/
+		crimild::Bool restore( Snapshot &snapshot );
+
+		/**
+		   \brief Restores the initial state of a new game with the given seed
+
+		   Resets the existing grid and snake in place, without going
+		   through a snapshot.
+		*/
+		crimild::Bool restart( crimild::UInt64 seed );
+
 	private:
+		/**
+		   \brief Rebuilds the head and trail from the snake and starts a new recording
+		*/
+		void resume( void );
+
 		crimild::Bool step( void );
+		void turn( Snake::Turn turn );
+		void queueTurn( Snake::Turn turn );
+
+		/**
+		   \brief Places the head between the last two cells, alpha being how far into the next step we are
+		*/
+		void updateHead( crimild::Real32 alpha );
+		void gameOver( void );
 
 	private:
-		crimild::Real32 _t = 0.0f;
-		crimild::Real32 _speed = 10.0f;
-
-		enum class Direction {
-			UP,
-			DOWN,
-			LEFT,
-			RIGHT,
-		};
+		FixedStepScheduler _scheduler;
 
-		Direction _direction;
+		Snake _snake;
 
-		struct TailNode {
-			crimild::Vector2i pos;
-			crimild::Node *node;
+		crimild::Node *_head = nullptr;
+		crimild::Vector3f _headFrom;
+		crimild::Vector3f _headTo;
+
+		/**
+		   Turns are applied one per step, in the order the keys were
+		   pressed, so quick turns between two steps are not lost.
+		   Turns pressed while the queue is full are dropped.
+		*/
+		struct QueuedTurn {
+			Snake::Turn turn;
+			std::chrono::steady_clock::time_point time;
 		};
 
-		crimild::Node *_head = nullptr;
-		crimild::containers::Queue< TailNode > _tail;
+		static constexpr crimild::Size TURN_QUEUE_SIZE = 3;
+
+		RingBuffer< QueuedTurn > _turnQueue;
+		crimild::Bool _leftDown = false;
+		crimild::Bool _rightDown = false;
+
+		Replay _recording;
+		crimild::SharedPointer< Replay > _replay;
+		crimild::Size _replayCursor = 0;
+		crimild::UInt64 _fastForwardUntil = 0;
+
+		/**
+		   Plays on its own when "autoplay=1", for demo kiosks. Key
+		   presses still take precedence.
+		*/
+		std::unique_ptr< AutoPlayer > _autoPlayer;
 
 	private:
+		/**
+		   \brief (Re)creates the trail mesh with room for the given number of segments
+
+		   The trail is drawn as a single LINES primitive whose vertex
+		   buffer is used as a ring: each step writes one segment and
+		   collapses the oldest one, so the buffer is never reallocated
+		   unless the tail outgrows it. Only the segments written since
+		   the last frame are uploaded.
+		*/
+		void createTrail( crimild::Size capacity );
+		void pushTrailSegment( const crimild::Vector3f &from, const crimild::Vector3f &to );
+		void markTrailDirty( crimild::Size slot );
+
+		/**
+		   \brief Hands the current path to the particle generator
+		*/
+		void updateTrailView( void );
 		void renderTail( void );
 
 	private:
 		crimild::Geometry *_renderer = nullptr;
-		crimild::NodePositionParticleGenerator *_posGenerator = nullptr;
+		crimild::VertexBufferObject *_trailVBO = nullptr;
+		StreamingVertexBufferObjectCatalog *_trailCatalog = nullptr;
+		crimild::Size _trailCapacity = 0;
+		crimild::Size _trailNext = 0;
+		crimild::Size _trailCount = 0;
+		crimild::Bool _trailDirty = false;
+
+		/**
+		   Particles are emitted along the tail. The path gains and
+		   drops segments together with the trail mesh.
+		*/
+		TrailPath _trailPath;
+		crimild::TrailPositionParticleGenerator *_trailGenerator = nullptr;
+		crimild::ParticleSystemComponent *_particleSystem = nullptr;
 	};
 
 }
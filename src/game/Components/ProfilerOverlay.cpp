@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ProfilerOverlay.hpp"
+
+#include <cstdio>
+
+using namespace hunger;
+
+using namespace crimild;
+
+ProfilerFrameTracker::ProfilerFrameTracker( void )
+{
+
+}
+
+ProfilerFrameTracker::~ProfilerFrameTracker( void )
+{
+
+}
+
+void ProfilerFrameTracker::update( const Clock & )
+{
+	if ( auto profiler = Profiler::getInstance() ) {
+		profiler->endFrame();
+	}
+}
+
+ProfilerOverlay::ProfilerOverlay( SharedPointer< Font > const &font )
+	: _font( font )
+{
+	for ( crimild::Int32 i = 0; i < Profiler::PHASE_COUNT; i++ ) {
+		_labels[ i ] = nullptr;
+	}
+}
+
+ProfilerOverlay::~ProfilerOverlay( void )
+{
+
+}
+
+void ProfilerOverlay::onAttach( void )
+{
+	auto parent = getNode< Group >();
+
+	auto createLabel = [ this, parent ]( const char *text, crimild::Int32 line ) {
+		auto label = crimild::alloc< Text >();
+		label->setFont( _font );
+		label->setSize( 0.02f );
+		label->setTextColor( RGBAColorf( 0.0f, 0.0f, 0.0f, 1.0f ) );
+		label->setText( text );
+		label->setHorizontalAlignment( Text::HorizontalAlignment::LEFT );
+		label->local().setTranslate( 0.35f, 0.525f - 0.03f * line, 0.0f );
+		parent->attachNode( label );
+		return crimild::get_ptr( label );
+	};
+
+	for ( crimild::Int32 i = 0; i < Profiler::PHASE_COUNT; i++ ) {
+		_labels[ i ] = createLabel( Profiler::getPhaseName( Profiler::Phase( i ) ), i );
+	}
+	_inputLabel = createLabel( "input", Profiler::PHASE_COUNT );
+}
+
+void ProfilerOverlay::update( const Clock &c )
+{
+	auto profiler = Profiler::getInstance();
+	if ( profiler == nullptr ) {
+		return;
+	}
+
+	// rebuilding text is not free, so only refresh a few times per second
+	_refreshTime -= c.getDeltaTime();
+	if ( _refreshTime > 0.0f ) {
+		return;
+	}
+	_refreshTime = 0.25f;
+
+	char buffer[ 128 ];
+	for ( crimild::Int32 i = 0; i < Profiler::PHASE_COUNT; i++ ) {
+		auto phase = Profiler::Phase( i );
+		std::snprintf(
+			buffer,
+			sizeof( buffer ),
+			"%s p50 %.2f p99 %.2f ms",
+			Profiler::getPhaseName( phase ),
+			profiler->getPercentile( phase, 0.5 ),
+			profiler->getPercentile( phase, 0.99 ) );
+		_labels[ i ]->setText( buffer );
+	}
+
+	std::snprintf(
+		buffer,
+		sizeof( buffer ),
+		"input p50 %.0f p99 %.0f us",
+		profiler->getInputLatencyPercentile( 0.5 ),
+		profiler->getInputLatencyPercentile( 0.99 ) );
+	_inputLabel->setText( buffer );
+}
+
+void ProfilerParticleGenerator::generate( Node *, crimild::Real64, ParticleData *, ParticleId, ParticleId )
+{
+	if ( auto profiler = Profiler::getInstance() ) {
+		if ( _begin ) {
+			profiler->begin( Profiler::PHASE_PARTICLE_GENERATE );
+		}
+		else {
+			profiler->end( Profiler::PHASE_PARTICLE_GENERATE );
+		}
+	}
+}
+
+void ProfilerParticleUpdater::update( Node *, crimild::Real64, ParticleData * )
+{
+	if ( auto profiler = Profiler::getInstance() ) {
+		if ( _begin ) {
+			profiler->begin( Profiler::PHASE_PARTICLE_UPDATE );
+		}
+		else {
+			profiler->end( Profiler::PHASE_PARTICLE_UPDATE );
+		}
+	}
+}
+
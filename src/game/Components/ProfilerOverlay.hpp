@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_COMPONENTS_PROFILER_OVERLAY_
+#define HUNGER_COMPONENTS_PROFILER_OVERLAY_
+
+#include "Logic/Profiler.hpp"
+
+#include <Crimild.hpp>
+
+namespace hunger {
+
+	/**
+	   \brief Closes a profiler frame on every update
+
+	   Attach it to the scene root, which is updated once per frame
+	   whatever parts of the UI are enabled.
+	*/
+	class ProfilerFrameTracker : public crimild::NodeComponent {
+		CRIMILD_IMPLEMENT_RTTI( hunger::ProfilerFrameTracker )
+
+	public:
+		ProfilerFrameTracker( void );
+		virtual ~ProfilerFrameTracker( void );
+
+		virtual void update( const crimild::Clock &c ) override;
+	};
+
+	/**
+	   \brief Shows rolling p50/p99 times for each frame phase and for input latency
+
+	   Only reads the profiler. Frames are closed by ProfilerFrameTracker.
+	*/
+	class ProfilerOverlay : public crimild::NodeComponent {
+		CRIMILD_IMPLEMENT_RTTI( hunger::ProfilerOverlay )
+
+	public:
+		explicit ProfilerOverlay( crimild::SharedPointer< crimild::Font > const &font );
+		virtual ~ProfilerOverlay( void );
+
+		virtual void onAttach( void ) override;
+		virtual void update( const crimild::Clock &c ) override;
+
+	private:
+		crimild::SharedPointer< crimild::Font > _font;
+		crimild::Text *_labels[ Profiler::PHASE_COUNT ];
+		crimild::Text *_inputLabel = nullptr;
+		crimild::Real32 _refreshTime = 0.0f;
+	};
+
+	/**
+	   \brief Starts or ends a profiler phase when the particle system runs its generators
+
+	   Add one at the beginning and one at the end of the generator list.
+	*/
+	class ProfilerParticleGenerator : public crimild::ParticleSystemComponent::ParticleGenerator {
+		CRIMILD_IMPLEMENT_RTTI( hunger::ProfilerParticleGenerator )
+
+	public:
+		explicit ProfilerParticleGenerator( crimild::Bool begin ) : _begin( begin ) { }
+		virtual ~ProfilerParticleGenerator( void ) { }
+
+		virtual void configure( crimild::Node *, crimild::ParticleData * ) override { }
+		virtual void generate( crimild::Node *node, crimild::Real64 dt, crimild::ParticleData *particles, crimild::ParticleId startId, crimild::ParticleId endId ) override;
+
+	private:
+		crimild::Bool _begin;
+	};
+
+	/**
+	   \brief Starts or ends a profiler phase when the particle system runs its updaters
+
+	   Add one at the beginning and one at the end of the updater list.
+	*/
+	class ProfilerParticleUpdater : public crimild::ParticleSystemComponent::ParticleUpdater {
+		CRIMILD_IMPLEMENT_RTTI( hunger::ProfilerParticleUpdater )
+
+	public:
+		explicit ProfilerParticleUpdater( crimild::Bool begin ) : _begin( begin ) { }
+		virtual ~ProfilerParticleUpdater( void ) { }
+
+		virtual void configure( crimild::Node *, crimild::ParticleData * ) override { }
+		virtual void update( crimild::Node *node, crimild::Real64 dt, crimild::ParticleData *particles ) override;
+
+	private:
+		crimild::Bool _begin;
+	};
+
+}
+
+#endif
+
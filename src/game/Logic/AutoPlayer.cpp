@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "AutoPlayer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace hunger;
+
+using namespace crimild;
+
+constexpr crimild::Size AutoPlayer::SEARCH_ROW_BUDGET;
+constexpr crimild::Size AutoPlayer::MOVE_COUNT;
+
+AutoPlayer::AutoPlayer( crimild::Int32 width, crimild::Int32 height )
+	: _width( width ),
+	  _height( height ),
+	  _field( width, height ),
+	  _distance( crimild::Size( width ) * height, 0 ),
+	  _room( width, height )
+{
+
+}
+
+AutoPlayer::~AutoPlayer( void )
+{
+
+}
+
+AutoPlayer::Move AutoPlayer::decide( const Grid *grid, const Snake &snake )
+{
+	const auto &occupied = grid->getOccupancy();
+	const Move moves[ MOVE_COUNT ] = { Move::STRAIGHT, Move::LEFT, Move::RIGHT };
+
+	Vector2i cells[ MOVE_COUNT ];
+	crimild::Bool open[ MOVE_COUNT ];
+	for ( crimild::Size i = 0; i < MOVE_COUNT; i++ ) {
+		auto direction = snake.getDirection();
+		if ( moves[ i ] != Move::STRAIGHT ) {
+			direction = Snake::turned( direction, moves[ i ] == Move::LEFT ? Snake::Turn::LEFT : Snake::Turn::RIGHT );
+		}
+		auto cell = snake.getPosition() + Snake::getOffset( direction );
+		cell = Vector2i( ( cell.x() + _width ) % _width, ( cell.y() + _height ) % _height );
+		cells[ i ] = cell;
+		open[ i ] = !occupied.test( cell.x(), cell.y() );
+	}
+
+	// A field that was cheap to build is built again, so it accounts
+	// for the cells the snake moved through. An expensive one is kept
+	// while its consumable is there: the snake only occupies cells
+	// behind the head, so its distances are still good enough.
+	if ( !_hasTarget || !grid->hasConsumable( _target ) || _fieldRows < SEARCH_ROW_BUDGET ) {
+		pickTarget( grid, snake.getPosition() );
+	}
+
+	// grow the field until it reaches one of the candidate cells
+	auto reached = [ & ] {
+		for ( crimild::Size i = 0; i < MOVE_COUNT; i++ ) {
+			if ( open[ i ] && _field.isVisited( cells[ i ] ) ) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	crimild::Size rows = 0;
+	while ( _hasTarget && !reached() && rows < SEARCH_ROW_BUDGET ) {
+		if ( _field.isExhausted() ) {
+			// unreachable for now. The tail will move, so try again later
+			pickTarget( grid, snake.getPosition() );
+			break;
+		}
+		rows += _field.getFrontierRowCount();
+		_field.expand( occupied, _distance.data() );
+	}
+	_fieldRows += rows;
+
+	crimild::Int32 best = -1;
+	for ( crimild::Size i = 0; i < MOVE_COUNT; i++ ) {
+		if ( open[ i ] && _field.isVisited( cells[ i ] ) ) {
+			auto d = _distance[ cells[ i ].y() * _width + cells[ i ].x() ];
+			if ( best < 0 || d < _distance[ cells[ best ].y() * _width + cells[ best ].x() ] ) {
+				best = i;
+			}
+		}
+	}
+
+	// Make sure there's room for the whole snake after the move. The
+	// tail will move too, so this is conservative.
+	const auto room = snake.getTailLength();
+	crimild::Size area[ MOVE_COUNT ] = { 0, 0, 0 };
+
+	if ( best >= 0 ) {
+		area[ best ] = measureRoom( occupied, cells[ best ], room );
+		if ( area[ best ] >= room ) {
+			return moves[ best ];
+		}
+	}
+
+	crimild::Int32 roomiest = 0;
+	for ( crimild::Size i = 0; i < MOVE_COUNT; i++ ) {
+		if ( crimild::Int32( i ) != best && open[ i ] ) {
+			area[ i ] = measureRoom( occupied, cells[ i ], room );
+		}
+		if ( area[ i ] > area[ roomiest ] ) {
+			roomiest = i;
+		}
+	}
+
+	return moves[ roomiest ];
+}
+
+void AutoPlayer::pickTarget( const Grid *grid, const Vector2i &head )
+{
+	_hasTarget = false;
+
+	crimild::Int32 closest = 0;
+	grid->eachConsumable( [ & ]( const Vector2i &cell, crimild::Int32 ) {
+		// shortest way around the torus on each axis
+		auto dx = std::abs( cell.x() - head.x() );
+		auto dy = std::abs( cell.y() - head.y() );
+		auto d = std::min( dx, _width - dx ) + std::min( dy, _height - dy );
+		if ( !_hasTarget || d < closest ) {
+			_target = cell;
+			closest = d;
+			_hasTarget = true;
+		}
+	});
+
+	_fieldRows = 0;
+	if ( _hasTarget ) {
+		_field.begin();
+		_field.addSource( _target );
+		_distance[ _target.y() * _width + _target.x() ] = 0;
+	}
+}
+
+crimild::Size AutoPlayer::measureRoom( const BitGrid &occupied, const Vector2i &cell, crimild::Size limit )
+{
+	_room.begin();
+	_room.addSource( cell );
+
+	crimild::Size count = 1;
+	while ( count < limit ) {
+		auto reached = _room.expand( occupied );
+		if ( reached == 0 ) {
+			break;
+		}
+		count += reached;
+	}
+
+	return count;
+}
+
+namespace hunger {
+
+	namespace autoplayer {
+
+		/**
+		   \brief Calls fn( k ) for every word k covered by the set bits of mask
+		*/
+		template< typename Fn >
+		inline void eachWord( BitGrid::Word mask, crimild::Int32 wordsPerBit, crimild::Int32 stride, Fn fn )
+		{
+			while ( mask != 0 ) {
+				auto b = bits::countTrailingZeros( mask );
+				mask &= mask - 1;
+				auto end = std::min( ( b + 1 ) * wordsPerBit, stride );
+				for ( auto k = b * wordsPerBit; k < end; k++ ) {
+					fn( k );
+				}
+			}
+		}
+
+	}
+
+}
+
+AutoPlayer::Flood::Flood( crimild::Int32 width, crimild::Int32 height )
+	: _width( width ),
+	  _height( height ),
+	  _visited( width, height ),
+	  _frontier( width, height ),
+	  _next( width, height ),
+	  _frontierMasks( height, 0 ),
+	  _nextMasks( height, 0 )
+{
+	_stride = _visited.getStride();
+	_lastWordMask = ( width & 63 ) != 0 ? ( BitGrid::Word( 1 ) << ( width & 63 ) ) - 1 : ~BitGrid::Word( 0 );
+	_wordsPerBit = ( _stride + BitGrid::WORD_BITS - 1 ) / BitGrid::WORD_BITS;
+	_frontierRows.reserve( height );
+	_nextRows.reserve( height );
+}
+
+void AutoPlayer::Flood::begin( void )
+{
+	_visited.clear();
+	for ( auto y : _frontierRows ) {
+		std::fill( _frontier.getRow( y ), _frontier.getRow( y ) + _stride, 0 );
+		_frontierMasks[ y ] = 0;
+	}
+	_frontierRows.clear();
+	_layer = 0;
+}
+
+void AutoPlayer::Flood::addSource( const Vector2i &cell )
+{
+	if ( _visited.test( cell.x(), cell.y() ) ) {
+		return;
+	}
+
+	_visited.set( cell.x(), cell.y(), true );
+	_frontier.set( cell.x(), cell.y(), true );
+
+	auto &mask = _frontierMasks[ cell.y() ];
+	if ( mask == 0 ) {
+		_frontierRows.push_back( cell.y() );
+	}
+	mask |= BitGrid::Word( 1 ) << ( ( cell.x() >> 6 ) / _wordsPerBit );
+}
+
+crimild::Size AutoPlayer::Flood::expand( const BitGrid &occupied, crimild::Int32 *distance )
+{
+	const auto last = _stride - 1;
+	const auto topBit = ( _width - 1 ) & 63;
+	const auto wordsPerBit = _wordsPerBit;
+	const auto stride = _stride;
+
+	// row masks may only grow by one bit to each side, wrapping around
+	const auto lastMaskBit = last / wordsPerBit;
+	const auto validMaskBits = lastMaskBit == 63 ? ~BitGrid::Word( 0 ) : ( BitGrid::Word( 2 ) << lastMaskBit ) - 1;
+
+	auto touch = [ this ]( crimild::Int32 y, BitGrid::Word mask ) {
+		auto &m = _nextMasks[ y ];
+		if ( m == 0 ) {
+			_nextRows.push_back( y );
+		}
+		m |= mask;
+	};
+
+	_nextRows.clear();
+	++_layer;
+
+	for ( auto y : _frontierRows ) {
+		auto f = _frontier.getRow( y );
+		auto n = _next.getRow( y );
+		auto up = ( y + _height - 1 ) % _height;
+		auto down = ( y + 1 ) % _height;
+		auto nu = _next.getRow( up );
+		auto nd = _next.getRow( down );
+
+		auto mask = _frontierMasks[ y ];
+		auto grown = mask | ( mask << 1 ) | ( mask >> 1 );
+		grown |= ( mask & 1 ) << lastMaskBit;
+		grown |= ( mask >> lastMaskBit ) & 1;
+		touch( y, grown & validMaskBits );
+		touch( up, mask );
+		touch( down, mask );
+
+		autoplayer::eachWord( mask, wordsPerBit, stride, [ & ]( crimild::Int32 k ) {
+			auto w = f[ k ];
+
+			// neighbors in the same row
+			n[ k ] |= ( w << 1 ) | ( w >> 1 );
+			if ( k < last ) {
+				n[ k + 1 ] |= w >> 63;
+			}
+			if ( k > 0 ) {
+				n[ k - 1 ] |= w << 63;
+			}
+
+			// neighbors in the rows above and below, wrapping around the y axis
+			nu[ k ] |= w;
+			nd[ k ] |= w;
+		});
+
+		// wrap around the x axis. Words outside the mask are zero
+		n[ 0 ] |= ( f[ last ] >> topBit ) & 1;
+		n[ last ] |= ( f[ 0 ] & 1 ) << topBit;
+		n[ last ] &= _lastWordMask;
+	}
+
+	// the old frontier is not needed anymore
+	for ( auto y : _frontierRows ) {
+		auto f = _frontier.getRow( y );
+		autoplayer::eachWord( _frontierMasks[ y ], wordsPerBit, stride, [ f ]( crimild::Int32 k ) {
+			f[ k ] = 0;
+		});
+		_frontierMasks[ y ] = 0;
+	}
+	_frontierRows.clear();
+
+	// keep only free cells that were not reached before
+	crimild::Size reached = 0;
+	for ( auto y : _nextRows ) {
+		auto n = _next.getRow( y );
+		auto o = occupied.getRow( y );
+		auto v = _visited.getRow( y );
+		auto f = _frontier.getRow( y );
+		auto d = distance != nullptr ? distance + crimild::Size( y ) * _width : nullptr;
+
+		BitGrid::Word mask = 0;
+		autoplayer::eachWord( _nextMasks[ y ], wordsPerBit, stride, [ & ]( crimild::Int32 k ) {
+			auto w = n[ k ] & ~o[ k ] & ~v[ k ];
+			n[ k ] = 0;
+			f[ k ] = w;
+			v[ k ] |= w;
+			if ( w != 0 ) {
+				mask |= BitGrid::Word( 1 ) << ( k / wordsPerBit );
+				reached += bits::popCount( w );
+				for ( auto bitsLeft = w; d != nullptr && bitsLeft != 0; bitsLeft &= bitsLeft - 1 ) {
+					d[ ( k << 6 ) + bits::countTrailingZeros( bitsLeft ) ] = _layer;
+				}
+			}
+		});
+		_nextMasks[ y ] = 0;
+
+		if ( mask != 0 ) {
+			_frontierMasks[ y ] = mask;
+			_frontierRows.push_back( y );
+		}
+	}
+
+	return reached;
+}
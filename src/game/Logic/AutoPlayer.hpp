@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_AUTO_PLAYER_
+#define HUNGER_LOGIC_AUTO_PLAYER_
+
+#include "BitGrid.hpp"
+#include "Snake.hpp"
+
+#include <Crimild.hpp>
+
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Plans the snake's moves with a breadth-first flood fill
+
+	   The search runs on bitboards: each layer of the BFS dilates the
+	   whole frontier at once with word shifts (wrapping around both
+	   axes, like Grid::move) and masks it with the free cells, so the
+	   cost depends on the number of words in the active rows and not
+	   on the number of cells.
+
+	   The snake heads for the closest consumable, following a
+	   distance field flooded from it. The field only grows until it
+	   reaches one of the candidate cells next to the head, by at most
+	   SEARCH_ROW_BUDGET rows per decision, which bounds the time spent
+	   in any single step. Fields that take longer than that are kept
+	   between decisions. If the chosen move leads into an area smaller
+	   than the snake, it picks the move with the most room instead.
+	*/
+	class AutoPlayer {
+	public:
+		enum class Move {
+			STRAIGHT,
+			LEFT,
+			RIGHT,
+		};
+
+		/**
+		   Frontier rows expanded per decision, at most. Decisions made
+		   while the field is still growing keep the snake alive but
+		   don't chase the consumable.
+		*/
+		static constexpr crimild::Size SEARCH_ROW_BUDGET = 1 << 17;
+
+	public:
+		AutoPlayer( crimild::Int32 width, crimild::Int32 height );
+		~AutoPlayer( void );
+
+		/**
+		   \brief Picks the move to make before the snake's next step
+		*/
+		Move decide( const Grid *grid, const Snake &snake );
+
+	private:
+		static constexpr crimild::Size MOVE_COUNT = 3;
+
+		/**
+		   \brief State of a bitboard BFS
+		*/
+		class Flood {
+		public:
+			Flood( crimild::Int32 width, crimild::Int32 height );
+
+			/**
+			   \brief Starts a new search. Seed the frontier with addSource()
+			*/
+			void begin( void );
+			void addSource( const crimild::Vector2i &cell );
+
+			/**
+			   \brief Expands the frontier by one layer over free cells
+
+			   Returns the number of newly reached cells. If distance is
+			   not null, the layer number is written there for each of
+			   them, indexed by y * width + x.
+			*/
+			crimild::Size expand( const BitGrid &occupied, crimild::Int32 *distance = nullptr );
+
+			crimild::Bool isVisited( const crimild::Vector2i &cell ) const { return _visited.test( cell.x(), cell.y() ); }
+			crimild::Bool isExhausted( void ) const { return _frontierRows.empty(); }
+			crimild::Size getFrontierRowCount( void ) const { return _frontierRows.size(); }
+
+		private:
+			crimild::Int32 _width;
+			crimild::Int32 _height;
+			crimild::Int32 _stride;
+			BitGrid::Word _lastWordMask;
+			crimild::Int32 _layer = 0;
+
+			BitGrid _visited;
+			BitGrid _frontier;
+			BitGrid _next;
+
+			/**
+			   Only rows with frontier cells are expanded, and only the
+			   words that may hold frontier cells. Each bit of a row mask
+			   covers _wordsPerBit consecutive words of that row.
+			*/
+			crimild::Int32 _wordsPerBit;
+			std::vector< crimild::Int32 > _frontierRows;
+			std::vector< crimild::Int32 > _nextRows;
+			std::vector< BitGrid::Word > _frontierMasks;
+			std::vector< BitGrid::Word > _nextMasks;
+		};
+
+		/**
+		   \brief Picks the closest consumable, ignoring obstacles, and restarts the field from it
+		*/
+		void pickTarget( const Grid *grid, const crimild::Vector2i &head );
+
+		/**
+		   \brief Number of free cells reachable from cell, counting up to limit
+		*/
+		crimild::Size measureRoom( const BitGrid &occupied, const crimild::Vector2i &cell, crimild::Size limit );
+
+	private:
+		crimild::Int32 _width;
+		crimild::Int32 _height;
+
+		crimild::Bool _hasTarget = false;
+		crimild::Vector2i _target;
+		Flood _field;
+		std::vector< crimild::Int32 > _distance;
+		crimild::Size _fieldRows = 0;
+
+		Flood _room;
+	};
+
+}
+
+#endif
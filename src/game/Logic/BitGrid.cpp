@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "BitGrid.hpp"
+
+#if defined( __AVX2__ ) || defined( __SSE4_1__ )
+#include <immintrin.h>
+#endif
+
+using namespace hunger;
+
+namespace hunger {
+
+	namespace bits {
+
+		/**
+		   \brief Mask with bits [from, 64) set
+		*/
+		inline BitGrid::Word maskFrom( crimild::Int32 from )
+		{
+			return ~BitGrid::Word( 0 ) << from;
+		}
+
+		/**
+		   \brief Mask with bits [0, to] set
+		*/
+		inline BitGrid::Word maskTo( crimild::Int32 to )
+		{
+			return ~BitGrid::Word( 0 ) >> ( 63 - to );
+		}
+
+		crimild::Size popCount( const BitGrid::Word *words, crimild::Size count )
+		{
+			// four accumulators keep the popcnt units busy
+			crimild::Size c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+			crimild::Size i = 0;
+			for ( ; i + 4 <= count; i += 4 ) {
+				c0 += popCount( words[ i + 0 ] );
+				c1 += popCount( words[ i + 1 ] );
+				c2 += popCount( words[ i + 2 ] );
+				c3 += popCount( words[ i + 3 ] );
+			}
+			for ( ; i < count; i++ ) {
+				c0 += popCount( words[ i ] );
+			}
+			return c0 + c1 + c2 + c3;
+		}
+
+		crimild::Bool any( const BitGrid::Word *words, crimild::Size count )
+		{
+			crimild::Size i = 0;
+#if defined( __AVX2__ )
+			for ( ; i + 4 <= count; i += 4 ) {
+				auto v = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( words + i ) );
+				if ( !_mm256_testz_si256( v, v ) ) {
+					return true;
+				}
+			}
+#elif defined( __SSE4_1__ )
+			for ( ; i + 2 <= count; i += 2 ) {
+				auto v = _mm_loadu_si128( reinterpret_cast< const __m128i * >( words + i ) );
+				if ( !_mm_testz_si128( v, v ) ) {
+					return true;
+				}
+			}
+#endif
+			for ( ; i < count; i++ ) {
+				if ( words[ i ] != 0 ) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+	}
+
+}
+
+BitGrid::BitGrid( crimild::Int32 width, crimild::Int32 height )
+	: _width( width ),
+	  _height( height ),
+	  _stride( ( width + WORD_BITS - 1 ) / WORD_BITS ),
+	  _words( crimild::Size( _stride ) * height, 0 )
+{
+
+}
+
+BitGrid::~BitGrid( void )
+{
+
+}
+
+void BitGrid::clear( void )
+{
+	std::fill( _words.begin(), _words.end(), 0 );
+}
+
+crimild::Size BitGrid::count( void ) const
+{
+	return bits::popCount( _words.data(), _words.size() );
+}
+
+crimild::Size BitGrid::countInRow( crimild::Int32 x0, crimild::Int32 x1, crimild::Int32 y ) const
+{
+	if ( x0 >= x1 ) {
+		return 0;
+	}
+
+	auto row = getRow( y );
+	auto w0 = x0 >> 6;
+	auto w1 = ( x1 - 1 ) >> 6;
+	if ( w0 == w1 ) {
+		return bits::popCount( row[ w0 ] & bits::maskFrom( x0 & 63 ) & bits::maskTo( ( x1 - 1 ) & 63 ) );
+	}
+
+	return bits::popCount( row[ w0 ] & bits::maskFrom( x0 & 63 ) )
+		+ bits::popCount( row + w0 + 1, w1 - w0 - 1 )
+		+ bits::popCount( row[ w1 ] & bits::maskTo( ( x1 - 1 ) & 63 ) );
+}
+
+crimild::Int32 BitGrid::findNextClear( crimild::Int32 x, crimild::Int32 y ) const
+{
+	if ( x >= _width ) {
+		return -1;
+	}
+
+	auto row = getRow( y );
+	auto w = x >> 6;
+	auto clear = ~row[ w ] & bits::maskFrom( x & 63 );
+	while ( clear == 0 ) {
+		if ( ++w >= _stride ) {
+			return -1;
+		}
+		clear = ~row[ w ];
+	}
+
+	// padding bits are clear, so the result may fall outside the row
+	auto result = w * WORD_BITS + bits::countTrailingZeros( clear );
+	return result < _width ? result : -1;
+}
+
+crimild::Bool BitGrid::anyInRow( crimild::Int32 x0, crimild::Int32 x1, crimild::Int32 y ) const
+{
+	if ( x0 >= x1 ) {
+		return false;
+	}
+
+	auto row = getRow( y );
+	auto w0 = x0 >> 6;
+	auto w1 = ( x1 - 1 ) >> 6;
+	if ( w0 == w1 ) {
+		return ( row[ w0 ] & bits::maskFrom( x0 & 63 ) & bits::maskTo( ( x1 - 1 ) & 63 ) ) != 0;
+	}
+
+	return ( row[ w0 ] & bits::maskFrom( x0 & 63 ) ) != 0
+		|| ( row[ w1 ] & bits::maskTo( ( x1 - 1 ) & 63 ) ) != 0
+		|| bits::any( row + w0 + 1, w1 - w0 - 1 );
+}
+
+crimild::Bool BitGrid::any( crimild::Int32 x, crimild::Int32 y, crimild::Int32 width, crimild::Int32 height ) const
+{
+	for ( crimild::Int32 j = y; j < y + height; j++ ) {
+		if ( anyInRow( x, x + width, j ) ) {
+			return true;
+		}
+	}
+	return false;
+}
+
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_BIT_GRID_
+#define HUNGER_LOGIC_BIT_GRID_
+
+#include <Crimild.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+namespace hunger {
+
+	namespace bits {
+
+		inline crimild::Size popCount( crimild::UInt64 w )
+		{
+#if defined( _MSC_VER )
+			return __popcnt64( w );
+#else
+			return __builtin_popcountll( w );
+#endif
+		}
+
+		/**
+		   \brief Index of the lowest set bit. w must not be zero
+		*/
+		inline crimild::Int32 countTrailingZeros( crimild::UInt64 w )
+		{
+#if defined( _MSC_VER )
+			unsigned long idx;
+			_BitScanForward64( &idx, w );
+			return idx;
+#else
+			return __builtin_ctzll( w );
+#endif
+		}
+
+	}
+
+	/**
+	   \brief A 2D array of bits packed into 64-bit words
+
+	   Each row starts at a word boundary, so row queries never need
+	   to mask bits from the previous row. Padding bits at the end of
+	   each row are always zero.
+
+	   Range queries do not wrap around. Ranges must lie inside the grid.
+	*/
+	class BitGrid {
+	public:
+		using Word = crimild::UInt64;
+
+		static constexpr crimild::Int32 WORD_BITS = 64;
+
+	public:
+		BitGrid( crimild::Int32 width, crimild::Int32 height );
+		~BitGrid( void );
+
+		crimild::Int32 getWidth( void ) const { return _width; }
+		crimild::Int32 getHeight( void ) const { return _height; }
+
+		/**
+		   \brief Number of words in each row
+		*/
+		crimild::Int32 getStride( void ) const { return _stride; }
+
+		Word *getRow( crimild::Int32 y ) { return &_words[ y * _stride ]; }
+		const Word *getRow( crimild::Int32 y ) const { return &_words[ y * _stride ]; }
+
+		/**
+		   \brief All rows, back to back. There are getStride() * getHeight() words
+		*/
+		Word *getWords( void ) { return _words.data(); }
+		const Word *getWords( void ) const { return _words.data(); }
+		crimild::Size getWordCount( void ) const { return _words.size(); }
+
+		inline crimild::Bool test( crimild::Int32 x, crimild::Int32 y ) const
+		{
+			return ( getRow( y )[ x >> 6 ] >> ( x & 63 ) ) & 1;
+		}
+
+		inline void set( crimild::Int32 x, crimild::Int32 y, crimild::Bool value )
+		{
+			auto &w = getRow( y )[ x >> 6 ];
+			auto bit = Word( 1 ) << ( x & 63 );
+			w = value ? ( w | bit ) : ( w & ~bit );
+		}
+
+		void clear( void );
+
+		/**
+		   \brief Number of set bits in the whole grid
+		*/
+		crimild::Size count( void ) const;
+
+		/**
+		   \brief Number of set bits in [x0, x1) of row y
+		*/
+		crimild::Size countInRow( crimild::Int32 x0, crimild::Int32 x1, crimild::Int32 y ) const;
+
+		/**
+		   \brief Returns the first clear bit in row y at or after x, or -1 if none
+		*/
+		crimild::Int32 findNextClear( crimild::Int32 x, crimild::Int32 y ) const;
+
+		/**
+		   \brief Tests if any bit is set in [x0, x1) of row y
+		*/
+		crimild::Bool anyInRow( crimild::Int32 x0, crimild::Int32 x1, crimild::Int32 y ) const;
+
+		/**
+		   \brief Tests if any bit is set in the given rectangle
+		*/
+		crimild::Bool any( crimild::Int32 x, crimild::Int32 y, crimild::Int32 width, crimild::Int32 height ) const;
+
+	private:
+		crimild::Int32 _width;
+		crimild::Int32 _height;
+		crimild::Int32 _stride;
+		std::vector< Word > _words;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "EpisodeRunner.hpp"
+
+using namespace hunger;
+
+using namespace crimild;
+
+namespace hunger {
+
+	namespace runner {
+
+		// worlds are cheap to step, so hand them out in small batches
+		constexpr crimild::Size GRAIN = 16;
+
+	}
+
+}
+
+EpisodeRunner::EpisodeRunner( crimild::Size worldCount, crimild::Int32 width, crimild::Int32 height, crimild::Size consumableCount, crimild::UInt64 seed, crimild::Size threadCount )
+	: _episodeSteps( worldCount, 0 ),
+	  _pool( threadCount )
+{
+	_worlds.reserve( worldCount );
+	for ( crimild::Size i = 0; i < worldCount; i++ ) {
+		_worlds.push_back( std::unique_ptr< World >( new World( width, height, consumableCount, seed + i ) ) );
+	}
+}
+
+EpisodeRunner::~EpisodeRunner( void )
+{
+
+}
+
+void EpisodeRunner::reset( Observation *observations )
+{
+	_pool.parallelFor( _worlds.size(), runner::GRAIN, [ this, observations ]( crimild::Size begin, crimild::Size end ) {
+		for ( auto i = begin; i < end; i++ ) {
+			_worlds[ i ]->reset();
+			_episodeSteps[ i ] = 0;
+			if ( observations != nullptr ) {
+				observe( i, 0, false, observations );
+			}
+		}
+	});
+}
+
+void EpisodeRunner::step( const crimild::Int8 *actions, Observation *observations )
+{
+	_pool.parallelFor( _worlds.size(), runner::GRAIN, [ this, actions, observations ]( crimild::Size begin, crimild::Size end ) {
+		for ( auto i = begin; i < end; i++ ) {
+			auto world = _worlds[ i ].get();
+
+			switch ( actions[ i ] ) {
+				case ACTION_TURN_LEFT:
+					world->getSnake().turn( Snake::Turn::LEFT );
+					break;
+
+				case ACTION_TURN_RIGHT:
+					world->getSnake().turn( Snake::Turn::RIGHT );
+					break;
+
+				default:
+					break;
+			}
+
+			auto pickups = world->getPickupCount();
+			auto alive = world->step();
+			auto reward = crimild::Int32( world->getPickupCount() - pickups );
+			++_episodeSteps[ i ];
+
+			observe( i, reward, !alive, observations );
+
+			if ( !alive ) {
+				world->reset();
+				_episodeSteps[ i ] = 0;
+			}
+		}
+	});
+}
+
+void EpisodeRunner::observe( crimild::Size index, crimild::Int32 reward, crimild::Bool done, Observation *observations )
+{
+	auto world = _worlds[ index ].get();
+	const auto &snake = world->getSnake();
+
+	auto &o = observations[ index ];
+	o.x = snake.getPosition().x();
+	o.y = snake.getPosition().y();
+	o.direction = crimild::Int32( snake.getDirection() );
+	o.reward = reward;
+	o.done = done ? 1 : 0;
+	o.episodeSteps = _episodeSteps[ index ];
+}
+
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_EPISODE_RUNNER_
+#define HUNGER_LOGIC_EPISODE_RUNNER_
+
+#include "World.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <Crimild.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Hosts many independent worlds and steps them in parallel
+
+	   Meant for training and evaluating bots. Actions and observations
+	   are passed as flat arrays with one entry per world, so they can
+	   be shared with other runtimes without conversions. A world that
+	   ends an episode is reset right away and reports done = 1 for
+	   that step.
+	*/
+	class EpisodeRunner {
+	public:
+		enum Action : crimild::Int8 {
+			ACTION_STRAIGHT = 0,
+			ACTION_TURN_LEFT = 1,
+			ACTION_TURN_RIGHT = 2,
+		};
+
+		struct Observation {
+			crimild::Int32 x;
+			crimild::Int32 y;
+			crimild::Int32 direction;
+			crimild::Int32 reward;
+			crimild::Int32 done;
+			crimild::Int32 episodeSteps;
+		};
+
+	public:
+		/**
+		   \param threadCount Zero means one thread per hardware thread
+		*/
+		EpisodeRunner( crimild::Size worldCount, crimild::Int32 width, crimild::Int32 height, crimild::Size consumableCount = 5, crimild::UInt64 seed = 0, crimild::Size threadCount = 0 );
+		~EpisodeRunner( void );
+
+		crimild::Size getWorldCount( void ) const { return _worlds.size(); }
+		World *getWorld( crimild::Size index ) { return _worlds[ index ].get(); }
+
+		crimild::Size getThreadCount( void ) const { return _pool.getThreadCount(); }
+
+		/**
+		   \brief Resets all worlds. observations may be null
+		*/
+		void reset( Observation *observations );
+
+		/**
+		   \brief Applies one action to each world and steps all of them once
+
+		   Both arrays must have getWorldCount() entries.
+		*/
+		void step( const crimild::Int8 *actions, Observation *observations );
+
+	private:
+		void observe( crimild::Size index, crimild::Int32 reward, crimild::Bool done, Observation *observations );
+
+	private:
+		std::vector< std::unique_ptr< World > > _worlds;
+		std::vector< crimild::Int32 > _episodeSteps;
+		WorkStealingPool _pool;
+	};
+
+}
+
+#endif
+
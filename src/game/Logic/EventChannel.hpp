@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_EVENT_CHANNEL_
+#define HUNGER_LOGIC_EVENT_CHANNEL_
+
+#include <Crimild.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Queue of typed events, delivered in batches
+
+	   Listeners are a function pointer and a context pointer, so
+	   dispatching never allocates or goes through the global message
+	   queue. Events pushed during a step are stored by value and
+	   delivered together when flush() is called at the end of the
+	   step, in the order they were pushed.
+
+	   A channel belongs to a single world and is not thread-safe.
+	   Listeners must not subscribe or unsubscribe while flushing.
+	*/
+	template< typename Event >
+	class EventChannel {
+	public:
+		using Listener = void (*)( void *context, const Event &event );
+
+	public:
+		EventChannel( void ) { }
+		~EventChannel( void ) { }
+
+		void subscribe( Listener listener, void *context )
+		{
+			_subscriptions.push_back( Subscription { listener, context } );
+		}
+
+		/**
+		   \brief Subscribes a member function of the given object
+		*/
+		template< typename T, void ( T::*METHOD )( const Event & ) >
+		void subscribe( T *object )
+		{
+			subscribe( []( void *context, const Event &event ) {
+				( static_cast< T * >( context )->*METHOD )( event );
+			}, object );
+		}
+
+		/**
+		   \brief Removes every subscription with the given context
+		*/
+		void unsubscribe( void *context )
+		{
+			_subscriptions.erase(
+				std::remove_if( _subscriptions.begin(), _subscriptions.end(), [ context ]( const Subscription &s ) {
+					return s.context == context;
+				}),
+				_subscriptions.end() );
+		}
+
+		void push( const Event &event ) { _pending.push_back( event ); }
+
+		crimild::Size getPendingCount( void ) const { return _pending.size(); }
+
+		/**
+		   \brief Delivers pending events to all listeners
+
+		   Events pushed by listeners are delivered in the same flush.
+		*/
+		void flush( void )
+		{
+			while ( !_pending.empty() ) {
+				// buffers are swapped, not reallocated
+				std::swap( _pending, _delivering );
+				for ( const auto &event : _delivering ) {
+					for ( const auto &s : _subscriptions ) {
+						s.listener( s.context, event );
+					}
+				}
+				_delivering.clear();
+			}
+		}
+
+		/**
+		   \brief Drops pending events without delivering them
+		*/
+		void clear( void ) { _pending.clear(); }
+
+	private:
+		struct Subscription {
+			Listener listener;
+			void *context;
+		};
+
+		std::vector< Subscription > _subscriptions;
+		std::vector< Event > _pending;
+		std::vector< Event > _delivering;
+	};
+
+}
+
+#endif
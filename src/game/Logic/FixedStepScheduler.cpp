@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FixedStepScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace hunger;
+
+using namespace crimild;
+
+FixedStepScheduler::FixedStepScheduler( crimild::Size maxStepsPerFrame, crimild::Real32 maxFrameTime )
+	: _maxStepsPerFrame( std::max< crimild::Size >( maxStepsPerFrame, 1 ) ),
+	  _maxFrameTime( maxFrameTime )
+{
+
+}
+
+FixedStepScheduler::~FixedStepScheduler( void )
+{
+
+}
+
+crimild::Size FixedStepScheduler::advance( crimild::Real32 dt, crimild::Real32 stepTime )
+{
+	if ( dt <= 0.0f || isPause( dt ) || stepTime <= 0.0f ) {
+		return 0;
+	}
+
+	_accumulator += dt;
+
+	auto steps = crimild::Size( _accumulator / stepTime );
+	if ( steps > _maxStepsPerFrame ) {
+		// drop whole steps we can't afford, but keep the phase
+		steps = _maxStepsPerFrame;
+		_accumulator = std::fmod( _accumulator, stepTime ) + steps * stepTime;
+	}
+
+	_accumulator = std::max( 0.0f, _accumulator - steps * stepTime );
+	return steps;
+}
+
+crimild::Real32 FixedStepScheduler::getAlpha( crimild::Real32 stepTime ) const
+{
+	if ( stepTime <= 0.0f ) {
+		return 1.0f;
+	}
+
+	return std::min( _accumulator / stepTime, 1.0f );
+}
+
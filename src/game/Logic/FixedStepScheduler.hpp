@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_FIXED_STEP_SCHEDULER_
+#define HUNGER_LOGIC_FIXED_STEP_SCHEDULER_
+
+#include <Crimild.hpp>
+
+#include <algorithm>
+
+namespace hunger {
+
+	/**
+	   \brief Turns variable frame times into a number of fixed steps
+
+	   Frame time is accumulated and spent in whole steps. At most
+	   maxStepsPerFrame steps are run in a single frame; if the game
+	   falls further behind, the extra time is dropped instead of
+	   piling up (which would make the next frames even slower).
+	   Frames longer than maxFrameTime are treated as pauses (e.g.
+	   loading, or a window being dragged) and ignored.
+	*/
+	class FixedStepScheduler {
+	public:
+		explicit FixedStepScheduler( crimild::Size maxStepsPerFrame = 5, crimild::Real32 maxFrameTime = 1.0f );
+		~FixedStepScheduler( void );
+
+		crimild::Size getMaxStepsPerFrame( void ) const { return _maxStepsPerFrame; }
+		void setMaxStepsPerFrame( crimild::Size count ) { _maxStepsPerFrame = std::max< crimild::Size >( count, 1 ); }
+
+		void reset( void ) { _accumulator = 0.0f; }
+
+		crimild::Bool isPause( crimild::Real32 dt ) const { return dt > _maxFrameTime; }
+
+		/**
+		   \brief Adds the frame time and returns how many steps of stepTime seconds to run
+		*/
+		crimild::Size advance( crimild::Real32 dt, crimild::Real32 stepTime );
+
+		/**
+		   \brief How far the next step is, in [0, 1). Used to interpolate between steps
+		*/
+		crimild::Real32 getAlpha( crimild::Real32 stepTime ) const;
+
+	private:
+		crimild::Size _maxStepsPerFrame;
+		crimild::Real32 _maxFrameTime;
+		crimild::Real32 _accumulator = 0.0f;
+	};
+
+}
+
+#endif
+
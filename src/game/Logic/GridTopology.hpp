@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_GRID_TOPOLOGY_
+#define HUNGER_LOGIC_GRID_TOPOLOGY_
+
+#include <Crimild.hpp>
+
+namespace hunger {
+
+	/**
+	   \brief Wraparound and index arithmetic for a grid of any size
+
+	   Wrapping expects coordinates at most one grid size away, like
+	   the ones produced by moving one cell.
+	*/
+	class GridTopology {
+	public:
+		static constexpr crimild::Bool IS_STATIC = false;
+
+	public:
+		GridTopology( crimild::Int32 width, crimild::Int32 height )
+			: _width( width ),
+			  _height( height ),
+			  _stride( ( width + 63 ) / 64 )
+		{
+
+		}
+
+		crimild::Int32 getWidth( void ) const { return _width; }
+		crimild::Int32 getHeight( void ) const { return _height; }
+
+		inline crimild::Vector2i wrap( const crimild::Vector2i &pos ) const
+		{
+			return crimild::Vector2i( ( _width + pos.x() ) % _width, ( _height + pos.y() ) % _height );
+		}
+
+		/**
+		   \brief Cell index, 64 bits wide for very large sparse grids
+		*/
+		inline crimild::Int64 getIndex( const crimild::Vector2i &pos ) const
+		{
+			return crimild::Int64( pos.y() ) * _width + pos.x();
+		}
+
+		inline crimild::Vector2i getCell( crimild::Int64 index ) const
+		{
+			return crimild::Vector2i( crimild::Int32( index % _width ), crimild::Int32( index / _width ) );
+		}
+
+		/**
+		   \brief Index of the BitGrid word holding the given cell
+		*/
+		inline crimild::Int32 getWordIndex( const crimild::Vector2i &pos ) const
+		{
+			return pos.y() * _stride + ( pos.x() >> 6 );
+		}
+
+	private:
+		crimild::Int32 _width;
+		crimild::Int32 _height;
+		crimild::Int32 _stride;
+	};
+
+	/**
+	   \brief Same as GridTopology, with dimensions known at compile time
+
+	   The compiler folds the constants, so wrapping becomes a mask
+	   for power-of-two sizes and indexing a shift, or a multiply by a
+	   constant for other sizes.
+	*/
+	template< crimild::Int32 WIDTH, crimild::Int32 HEIGHT >
+	class StaticGridTopology {
+	public:
+		static constexpr crimild::Bool IS_STATIC = true;
+		static constexpr crimild::Int32 STRIDE = ( WIDTH + 63 ) / 64;
+
+	public:
+		constexpr crimild::Int32 getWidth( void ) const { return WIDTH; }
+		constexpr crimild::Int32 getHeight( void ) const { return HEIGHT; }
+
+		inline crimild::Vector2i wrap( const crimild::Vector2i &pos ) const
+		{
+			return crimild::Vector2i( wrap< WIDTH >( pos.x() ), wrap< HEIGHT >( pos.y() ) );
+		}
+
+		inline crimild::Int32 getIndex( const crimild::Vector2i &pos ) const
+		{
+			return pos.y() * WIDTH + pos.x();
+		}
+
+		inline crimild::Vector2i getCell( crimild::Int64 index ) const
+		{
+			return crimild::Vector2i( crimild::UInt32( index ) % WIDTH, crimild::UInt32( index ) / WIDTH );
+		}
+
+		inline crimild::Int32 getWordIndex( const crimild::Vector2i &pos ) const
+		{
+			return pos.y() * STRIDE + ( pos.x() >> 6 );
+		}
+
+	private:
+		template< crimild::Int32 SIZE >
+		static inline crimild::Int32 wrap( crimild::Int32 v )
+		{
+			// two's complement makes the mask work for -1 too
+			return ( SIZE & ( SIZE - 1 ) ) == 0 ? ( v & ( SIZE - 1 ) ) : crimild::Int32( crimild::UInt32( SIZE + v ) % SIZE );
+		}
+	};
+
+	template< crimild::Int32 WIDTH, crimild::Int32 HEIGHT >
+	constexpr crimild::Bool StaticGridTopology< WIDTH, HEIGHT >::IS_STATIC;
+
+	template< crimild::Int32 WIDTH, crimild::Int32 HEIGHT >
+	constexpr crimild::Int32 StaticGridTopology< WIDTH, HEIGHT >::STRIDE;
+
+	/**
+	   \brief Calls fn with the StaticGridTopology matching the given
+	   size if there is one, or with the runtime topology otherwise
+
+	   Covers the default 100x100 board and square power-of-two boards
+	   from 64 to 1024. fn must accept any topology (a generic lambda).
+	*/
+	template< typename Fn >
+	inline auto dispatchGridTopology( const GridTopology &topology, Fn fn ) -> decltype( fn( topology ) )
+	{
+		auto w = topology.getWidth();
+		auto h = topology.getHeight();
+
+		if ( w == 100 && h == 100 ) {
+			return fn( StaticGridTopology< 100, 100 >() );
+		}
+
+		if ( w == h ) {
+			switch ( w ) {
+				case 64: return fn( StaticGridTopology< 64, 64 >() );
+				case 128: return fn( StaticGridTopology< 128, 128 >() );
+				case 256: return fn( StaticGridTopology< 256, 256 >() );
+				case 512: return fn( StaticGridTopology< 512, 512 >() );
+				case 1024: return fn( StaticGridTopology< 1024, 1024 >() );
+				default: break;
+			}
+		}
+
+		return fn( topology );
+	}
+
+}
+
+#endif
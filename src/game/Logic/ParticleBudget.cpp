@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ParticleBudget.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace hunger;
+
+using namespace crimild;
+
+ParticleBudget::ParticleBudget( const Config &config )
+	: _config( config )
+{
+	auto needed = crimild::Size( std::ceil( std::max( 0.0f, _config.emitRate * _config.maxLifetime ) ) );
+	_poolSize = std::max< crimild::Size >( 1, std::min( needed, _config.maxParticles ) );
+}
+
+ParticleBudget::~ParticleBudget( void )
+{
+
+}
+
+crimild::Real32 ParticleBudget::update( crimild::Real64 dt )
+{
+	if ( dt > _config.frameBudget ) {
+		// back off quickly while over budget
+		_emitScale = std::max( _config.minEmitScale, _emitScale * 0.9f );
+	}
+	else {
+		_emitScale = std::min( 1.0f, _emitScale + 0.01f );
+	}
+
+	return getEmitRate();
+}
+
+crimild::Size ParticleBudget::computeCullCount( crimild::Size aliveCount, crimild::Real64 dt ) const
+{
+	auto nextFrame = crimild::Size( std::ceil( getEmitRate() * dt ) ) + 1;
+	if ( aliveCount + nextFrame <= _poolSize ) {
+		return 0;
+	}
+
+	auto batch = crimild::Size( std::ceil( getEmitRate() ) );
+	return std::min( aliveCount, std::max( aliveCount + nextFrame - _poolSize, batch ) );
+}
+
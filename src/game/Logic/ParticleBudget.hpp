@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_PARTICLE_BUDGET_
+#define HUNGER_LOGIC_PARTICLE_BUDGET_
+
+#include <Crimild.hpp>
+
+namespace hunger {
+
+	/**
+	   \brief Bounds the size and the per-frame cost of a particle system
+
+	   The pool only needs room for what can be alive at once, which
+	   is the emit rate times the longest lifetime, up to a fixed cap.
+	   When frames take longer than the frame budget, emission is
+	   scaled down, and it recovers slowly once frames are fast again.
+	*/
+	class ParticleBudget {
+	public:
+		struct Config {
+			crimild::Real32 emitRate = 100.0f;
+			crimild::Real32 maxLifetime = 200.0f;
+			crimild::Size maxParticles = 5000;
+			crimild::Real32 frameBudget = 1.0f / 50.0f;
+			crimild::Real32 minEmitScale = 0.1f;
+		};
+
+	public:
+		explicit ParticleBudget( const Config &config );
+		~ParticleBudget( void );
+
+		const Config &getConfig( void ) const { return _config; }
+
+		crimild::Size getPoolSize( void ) const { return _poolSize; }
+
+		/**
+		   \brief Adapts emission to the last frame time and returns the new emit rate
+		*/
+		crimild::Real32 update( crimild::Real64 dt );
+
+		crimild::Real32 getEmitRate( void ) const { return _config.emitRate * _emitScale; }
+		crimild::Real32 getEmitScale( void ) const { return _emitScale; }
+
+		/**
+		   \brief Number of particles to cull so the next frames have room to emit
+
+		   Culling is done in batches of about one second of emission,
+		   so the cost of picking the oldest particles is not paid every
+		   frame.
+		*/
+		crimild::Size computeCullCount( crimild::Size aliveCount, crimild::Real64 dt ) const;
+
+	private:
+		Config _config;
+		crimild::Size _poolSize;
+		crimild::Real32 _emitScale = 1.0f;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Profiler.hpp"
+
+#include <algorithm>
+
+using namespace hunger;
+
+using namespace crimild;
+
+const char *Profiler::getPhaseName( Phase phase )
+{
+	switch ( phase ) {
+		case PHASE_UPDATE: return "update";
+		case PHASE_STEP: return "step";
+		case PHASE_PARTICLE_GENERATE: return "particle_generate";
+		case PHASE_PARTICLE_UPDATE: return "particle_update";
+		case PHASE_ENGINE: return "engine";
+		case PHASE_FRAME: return "frame";
+		default: return "unknown";
+	}
+}
+
+Profiler::Profiler( crimild::Size window )
+	: _frameStart( Clock::now() ),
+	  _inputLatencies( 256 )
+{
+	window = std::max< crimild::Size >( window, 1 );
+	for ( crimild::Int32 i = 0; i < PHASE_COUNT; i++ ) {
+		_current[ i ] = Clock::duration::zero();
+		_samples[ i ].reserve( window );
+	}
+	_sorted.reserve( window );
+}
+
+Profiler::~Profiler( void )
+{
+
+}
+
+crimild::Bool Profiler::openCSV( const std::string &fileName )
+{
+	_csv.open( fileName );
+	if ( !_csv ) {
+		return false;
+	}
+
+	_csv << "frame";
+	for ( crimild::Int32 i = 0; i < PHASE_COUNT; i++ ) {
+		_csv << "," << getPhaseName( Phase( i ) ) << "_ms";
+	}
+	_csv << ",input_latency_us\n";
+
+	return true;
+}
+
+void Profiler::endFrame( void )
+{
+	auto now = Clock::now();
+	_current[ PHASE_FRAME ] = now - _frameStart;
+	_frameStart = now;
+
+	auto measured = _current[ PHASE_UPDATE ] + _current[ PHASE_PARTICLE_GENERATE ] + _current[ PHASE_PARTICLE_UPDATE ];
+	_current[ PHASE_ENGINE ] = std::max( _current[ PHASE_FRAME ] - measured, Clock::duration::zero() );
+
+	if ( _csv.is_open() ) {
+		_csv << _frameCount;
+	}
+
+	for ( crimild::Int32 i = 0; i < PHASE_COUNT; i++ ) {
+		auto ms = std::chrono::duration< crimild::Real32, std::milli >( _current[ i ] ).count();
+		auto &samples = _samples[ i ];
+		if ( samples.full() ) {
+			samples.pop();
+		}
+		samples.push( ms );
+		_current[ i ] = Clock::duration::zero();
+
+		if ( _csv.is_open() ) {
+			_csv << "," << ms;
+		}
+	}
+
+	if ( _csv.is_open() ) {
+		_csv << "," << _frameInputLatency << "\n";
+	}
+	_frameInputLatency = 0.0f;
+
+	++_frameCount;
+}
+
+crimild::Real64 Profiler::getPercentile( Phase phase, crimild::Real64 p ) const
+{
+	return getPercentile( _samples[ phase ], p );
+}
+
+void Profiler::recordInputLatency( Clock::duration latency )
+{
+	auto us = std::chrono::duration< crimild::Real32, std::micro >( latency ).count();
+	if ( _inputLatencies.full() ) {
+		_inputLatencies.pop();
+	}
+	_inputLatencies.push( us );
+	_frameInputLatency = std::max( _frameInputLatency, us );
+}
+
+crimild::Real64 Profiler::getInputLatencyPercentile( crimild::Real64 p ) const
+{
+	return getPercentile( _inputLatencies, p );
+}
+
+crimild::Real64 Profiler::getPercentile( const RingBuffer< crimild::Real32 > &samples, crimild::Real64 p ) const
+{
+	if ( samples.empty() ) {
+		return 0.0;
+	}
+
+	_sorted.clear();
+	for ( crimild::Size i = 0; i < samples.size(); i++ ) {
+		_sorted.push_back( samples[ i ] );
+	}
+
+	auto n = crimild::Size( std::min( std::max( p, 0.0 ), 1.0 ) * ( _sorted.size() - 1 ) + 0.5 );
+	std::nth_element( _sorted.begin(), _sorted.begin() + n, _sorted.end() );
+	return _sorted[ n ];
+}
+
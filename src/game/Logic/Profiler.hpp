@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_PROFILER_
+#define HUNGER_LOGIC_PROFILER_
+
+#include "RingBuffer.hpp"
+
+#include <Crimild.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Times each phase of a frame and keeps a rolling window of samples
+
+	   UPDATE covers component updates, including the fixed steps that
+	   are also reported on their own as STEP. Phases may be entered
+	   several times per frame (e.g. once per fixed step) and their
+	   times are added up until endFrame() is called. ENGINE is
+	   whatever is left of the frame after the measured phases, which
+	   is mostly world state updates and render submission.
+
+	   Timing is only done while a profiler exists, so Scope costs a
+	   null check otherwise.
+	*/
+	class Profiler : public crimild::DynamicSingleton< Profiler > {
+	public:
+		enum Phase {
+			PHASE_UPDATE,
+			PHASE_STEP,
+			PHASE_PARTICLE_GENERATE,
+			PHASE_PARTICLE_UPDATE,
+			PHASE_ENGINE,
+			PHASE_FRAME,
+			PHASE_COUNT,
+		};
+
+		using Clock = std::chrono::steady_clock;
+
+		static const char *getPhaseName( Phase phase );
+
+		/**
+		   \brief Times a phase for the lifetime of this object
+		*/
+		class Scope {
+		public:
+			explicit Scope( Phase phase )
+				: _profiler( Profiler::getInstance() ),
+				  _phase( phase )
+			{
+				if ( _profiler != nullptr ) {
+					_profiler->begin( _phase );
+				}
+			}
+
+			~Scope( void )
+			{
+				if ( _profiler != nullptr ) {
+					_profiler->end( _phase );
+				}
+			}
+
+		private:
+			Profiler *_profiler;
+			Phase _phase;
+		};
+
+	public:
+		/**
+		   \param window Number of frames used to compute percentiles
+		*/
+		explicit Profiler( crimild::Size window = 240 );
+		~Profiler( void );
+
+		/**
+		   \brief Writes one line per frame, with times in milliseconds
+
+		   The last column is the worst input latency of the frame, in
+		   microseconds, or zero if no input was applied.
+		*/
+		crimild::Bool openCSV( const std::string &fileName );
+
+		void begin( Phase phase ) { _start[ phase ] = Clock::now(); }
+		void end( Phase phase ) { _current[ phase ] += Clock::now() - _start[ phase ]; }
+
+		/**
+		   \brief Records the times accumulated since the last call as a new frame
+		*/
+		void endFrame( void );
+
+		crimild::Size getFrameCount( void ) const { return _frameCount; }
+
+		/**
+		   \brief Time in milliseconds at the given percentile, in [0, 1], of the window
+		*/
+		crimild::Real64 getPercentile( Phase phase, crimild::Real64 p ) const;
+
+		/**
+		   \brief Records the time between an input event and the step that applied it
+		*/
+		void recordInputLatency( Clock::duration latency );
+
+		/**
+		   \brief Input latency in microseconds at the given percentile, in [0, 1], of the last inputs
+		*/
+		crimild::Real64 getInputLatencyPercentile( crimild::Real64 p ) const;
+
+	private:
+		crimild::Real64 getPercentile( const RingBuffer< crimild::Real32 > &samples, crimild::Real64 p ) const;
+
+	private:
+		Clock::time_point _frameStart;
+		Clock::time_point _start[ PHASE_COUNT ];
+		Clock::duration _current[ PHASE_COUNT ];
+		RingBuffer< crimild::Real32 > _samples[ PHASE_COUNT ];
+		crimild::Size _frameCount = 0;
+
+		RingBuffer< crimild::Real32 > _inputLatencies;
+		crimild::Real32 _frameInputLatency = 0.0f;
+
+		mutable std::vector< crimild::Real32 > _sorted;
+
+		std::ofstream _csv;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_RANDOM_STREAM_
+#define HUNGER_LOGIC_RANDOM_STREAM_
+
+#include <Crimild.hpp>
+
+namespace hunger {
+
+	/**
+	   \brief Counter-based pseudo-random number stream
+
+	   The n-th value of a stream is a pure function of (key, n): the
+	   counter is hashed with the SplitMix64 finalizer. There is no
+	   state other than the counter, so a stream can be saved and
+	   restored as a single integer, and batches of values can be
+	   computed independently (and vectorized) since there's no
+	   dependency between consecutive draws.
+
+	   Not suitable for cryptography.
+	*/
+	class RandomStream {
+	public:
+		explicit RandomStream( crimild::UInt64 seed = 0, crimild::UInt64 stream = 0 )
+			: _key( mix( seed ^ mix( stream + 0x9E3779B97F4A7C15ull ) ) )
+		{
+
+		}
+
+		crimild::UInt64 getCounter( void ) const { return _counter; }
+		void setCounter( crimild::UInt64 counter ) { _counter = counter; }
+
+		/**
+		   \brief The value at an arbitrary position of the stream
+		*/
+		inline crimild::UInt64 at( crimild::UInt64 counter ) const
+		{
+			return mix( _key + counter * 0x9E3779B97F4A7C15ull );
+		}
+
+		inline crimild::UInt64 next( void )
+		{
+			return at( _counter++ );
+		}
+
+		/**
+		   \brief Uniform integer in [min, max)
+		*/
+		inline crimild::Int32 generate( crimild::Int32 min, crimild::Int32 max )
+		{
+			return min + toRange( next(), crimild::UInt32( max - min ) );
+		}
+
+		/**
+		   \brief Uniform integer in [0, max)
+		*/
+		inline crimild::Int32 generate( crimild::Int32 max )
+		{
+			return generate( 0, max );
+		}
+
+		/**
+		   \brief Uniform real in [min, max)
+		*/
+		inline crimild::Real32 generate( crimild::Real32 min, crimild::Real32 max )
+		{
+			return min + ( max - min ) * toUnit( next() );
+		}
+
+		/**
+		   \brief Fills out with count uniform reals in [min, max)
+
+		   Produces exactly the same values as calling generate count times
+		*/
+		void generate( crimild::Real32 *out, crimild::Size count, crimild::Real32 min, crimild::Real32 max )
+		{
+			const auto base = _counter;
+			const auto scale = max - min;
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				out[ i ] = min + scale * toUnit( at( base + i ) );
+			}
+			_counter += count;
+		}
+
+	private:
+		static inline crimild::UInt64 mix( crimild::UInt64 z )
+		{
+			z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+			z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+			return z ^ ( z >> 31 );
+		}
+
+		static inline crimild::Real32 toUnit( crimild::UInt64 x )
+		{
+			// top 24 bits fill the float mantissa exactly
+			return crimild::Real32( x >> 40 ) * ( 1.0f / 16777216.0f );
+		}
+
+		static inline crimild::Int32 toRange( crimild::UInt64 x, crimild::UInt32 range )
+		{
+			// multiply-shift instead of modulo (Lemire)
+			return crimild::Int32( ( ( x >> 32 ) * range ) >> 32 );
+		}
+
+	private:
+		crimild::UInt64 _key;
+		crimild::UInt64 _counter = 0;
+	};
+
+	/**
+	   \brief Independent streams used by a single world
+
+	   Keeping them separate means that, for example, changing the
+	   particle emission rate doesn't alter where consumables spawn.
+	*/
+	struct RandomStreams {
+		enum Stream : crimild::UInt64 {
+			STREAM_SPAWN = 1,
+			STREAM_GAMEPLAY = 2,
+			STREAM_PARTICLES = 3,
+		};
+
+		explicit RandomStreams( crimild::UInt64 seed = 0 )
+			: seed( seed ),
+			  spawn( seed, STREAM_SPAWN ),
+			  gameplay( seed, STREAM_GAMEPLAY ),
+			  particles( seed, STREAM_PARTICLES )
+		{
+
+		}
+
+		crimild::UInt64 seed;
+		RandomStream spawn;
+		RandomStream gameplay;
+		RandomStream particles;
+	};
+
+}
+
+#endif
+
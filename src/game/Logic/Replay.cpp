@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+using namespace hunger;
+
+namespace hunger {
+
+	namespace replay {
+
+		const crimild::UInt8 MAGIC[] = { 'H', 'R', 'P', 'L' };
+		// Bumped whenever the same seed and turns no longer produce the
+		// same game. Version 2 picks spawn cells from the free-cell
+		// index in row order, so older replays would diverge
+		constexpr crimild::UInt8 VERSION = 2;
+
+		void writeFixed( std::vector< crimild::UInt8 > &out, crimild::UInt64 value, crimild::Size bytes )
+		{
+			for ( crimild::Size i = 0; i < bytes; i++ ) {
+				out.push_back( crimild::UInt8( value >> ( 8 * i ) ) );
+			}
+		}
+
+		void writeVarint( std::vector< crimild::UInt8 > &out, crimild::UInt64 value )
+		{
+			while ( value >= 0x80 ) {
+				out.push_back( crimild::UInt8( value | 0x80 ) );
+				value >>= 7;
+			}
+			out.push_back( crimild::UInt8( value ) );
+		}
+
+		class Reader {
+		public:
+			Reader( const crimild::UInt8 *data, crimild::Size size ) : _data( data ), _size( size ) { }
+
+			crimild::Bool good( void ) const { return _good; }
+
+			crimild::UInt64 readFixed( crimild::Size bytes )
+			{
+				if ( _offset + bytes > _size ) {
+					_good = false;
+					return 0;
+				}
+
+				crimild::UInt64 value = 0;
+				for ( crimild::Size i = 0; i < bytes; i++ ) {
+					value |= crimild::UInt64( _data[ _offset++ ] ) << ( 8 * i );
+				}
+				return value;
+			}
+
+			crimild::UInt64 readVarint( void )
+			{
+				crimild::UInt64 value = 0;
+				for ( crimild::Size shift = 0; shift < 64; shift += 7 ) {
+					if ( _offset >= _size ) {
+						break;
+					}
+					auto byte = _data[ _offset++ ];
+					value |= crimild::UInt64( byte & 0x7F ) << shift;
+					if ( ( byte & 0x80 ) == 0 ) {
+						return value;
+					}
+				}
+				_good = false;
+				return 0;
+			}
+
+		private:
+			const crimild::UInt8 *_data;
+			crimild::Size _size;
+			crimild::Size _offset = 0;
+			crimild::Bool _good = true;
+		};
+
+	}
+
+}
+
+Replay::Replay( crimild::UInt64 seed, crimild::Int32 width, crimild::Int32 height, crimild::Int32 consumableCount )
+	: _seed( seed ),
+	  _width( width ),
+	  _height( height ),
+	  _consumableCount( consumableCount )
+{
+
+}
+
+Replay::~Replay( void )
+{
+
+}
+
+void Replay::record( crimild::UInt64 step, Snake::Turn turn )
+{
+	assert( _events.empty() || _events.back().step <= step );
+	_events.push_back( Event { step, turn } );
+}
+
+void Replay::encode( std::vector< crimild::UInt8 > &out ) const
+{
+	out.insert( out.end(), std::begin( replay::MAGIC ), std::end( replay::MAGIC ) );
+	out.push_back( replay::VERSION );
+	replay::writeFixed( out, _seed, 8 );
+	replay::writeFixed( out, crimild::UInt32( _width ), 4 );
+	replay::writeFixed( out, crimild::UInt32( _height ), 4 );
+	replay::writeFixed( out, crimild::UInt32( _consumableCount ), 4 );
+
+	replay::writeVarint( out, _events.size() );
+	crimild::UInt64 prev = 0;
+	for ( const auto &e : _events ) {
+		replay::writeVarint( out, ( ( e.step - prev ) << 1 ) | ( e.turn == Snake::Turn::RIGHT ? 1 : 0 ) );
+		prev = e.step;
+	}
+}
+
+crimild::Bool Replay::decode( const crimild::UInt8 *data, crimild::Size size )
+{
+	if ( size < sizeof( replay::MAGIC ) + 1 || !std::equal( std::begin( replay::MAGIC ), std::end( replay::MAGIC ), data ) || data[ 4 ] != replay::VERSION ) {
+		return false;
+	}
+
+	replay::Reader reader( data + 5, size - 5 );
+	auto seed = reader.readFixed( 8 );
+	auto width = crimild::Int32( reader.readFixed( 4 ) );
+	auto height = crimild::Int32( reader.readFixed( 4 ) );
+	auto consumableCount = crimild::Int32( reader.readFixed( 4 ) );
+	auto count = reader.readVarint();
+	if ( !reader.good() ) {
+		return false;
+	}
+
+	std::vector< Event > events;
+	crimild::UInt64 step = 0;
+	for ( crimild::UInt64 i = 0; i < count && reader.good(); i++ ) {
+		auto value = reader.readVarint();
+		step += value >> 1;
+		events.push_back( Event { step, ( value & 1 ) ? Snake::Turn::RIGHT : Snake::Turn::LEFT } );
+	}
+
+	if ( !reader.good() ) {
+		return false;
+	}
+
+	_seed = seed;
+	_width = width;
+	_height = height;
+	_consumableCount = consumableCount;
+	_events.swap( events );
+	return true;
+}
+
+crimild::Bool Replay::save( const std::string &path ) const
+{
+	std::vector< crimild::UInt8 > data;
+	encode( data );
+
+	std::ofstream out( path, std::ios::binary );
+	out.write( reinterpret_cast< const char * >( data.data() ), data.size() );
+	return out.good();
+}
+
+crimild::Bool Replay::load( const std::string &path )
+{
+	std::ifstream in( path, std::ios::binary );
+	if ( !in.good() ) {
+		return false;
+	}
+
+	std::vector< crimild::UInt8 > data( ( std::istreambuf_iterator< char >( in ) ), std::istreambuf_iterator< char >() );
+	return decode( data.data(), data.size() );
+}
+
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_REPLAY_
+#define HUNGER_LOGIC_REPLAY_
+
+#include "Snake.hpp"
+
+#include <Crimild.hpp>
+
+#include <string>
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Compact log of a game session
+
+	   Since games are deterministic for a given seed, a session is
+	   fully described by its seed, the board settings and the turns
+	   made by the player, each one tagged with the index of the step
+	   it was applied to.
+
+	   Serialized layout (little endian):
+	   - "HRPL" magic and a version byte
+	   - seed (8 bytes), width, height and consumable count (4 bytes each)
+	   - event count as a varint
+	   - one varint per event: ( stepDelta << 1 ) | ( turn == RIGHT )
+
+	   Step deltas are usually small, so most events take one byte.
+	   Files from another version are rejected, since they were
+	   recorded with different game rules.
+	*/
+	class Replay {
+	public:
+		struct Event {
+			crimild::UInt64 step;
+			Snake::Turn turn;
+		};
+
+	public:
+		Replay( crimild::UInt64 seed = 0, crimild::Int32 width = 0, crimild::Int32 height = 0, crimild::Int32 consumableCount = 0 );
+		~Replay( void );
+
+		crimild::UInt64 getSeed( void ) const { return _seed; }
+		crimild::Int32 getWidth( void ) const { return _width; }
+		crimild::Int32 getHeight( void ) const { return _height; }
+		crimild::Int32 getConsumableCount( void ) const { return _consumableCount; }
+
+		void clear( void ) { _events.clear(); }
+
+		/**
+		   \brief Adds a turn applied right before the given step
+
+		   Steps must be recorded in non-decreasing order
+		*/
+		void record( crimild::UInt64 step, Snake::Turn turn );
+
+		crimild::Size getEventCount( void ) const { return _events.size(); }
+		const Event &getEvent( crimild::Size index ) const { return _events[ index ]; }
+
+		/**
+		   \brief Calls fn( turn ) for every event of the given step
+
+		   cursor is the index of the next event to play. Returns the
+		   updated cursor.
+		*/
+		template< typename Fn >
+		crimild::Size play( crimild::Size cursor, crimild::UInt64 step, Fn fn ) const
+		{
+			while ( cursor < _events.size() && _events[ cursor ].step <= step ) {
+				fn( _events[ cursor ].turn );
+				++cursor;
+			}
+			return cursor;
+		}
+
+		void encode( std::vector< crimild::UInt8 > &out ) const;
+		crimild::Bool decode( const crimild::UInt8 *data, crimild::Size size );
+
+		crimild::Bool save( const std::string &path ) const;
+		crimild::Bool load( const std::string &path );
+
+	private:
+		crimild::UInt64 _seed;
+		crimild::Int32 _width;
+		crimild::Int32 _height;
+		crimild::Int32 _consumableCount;
+		std::vector< Event > _events;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_RING_BUFFER_
+#define HUNGER_LOGIC_RING_BUFFER_
+
+#include <Crimild.hpp>
+
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Fixed-capacity FIFO stored in a contiguous array
+
+	   Elements are indexed from the oldest (0) to the newest
+	   (size() - 1). Pushing into a full buffer is an error; call
+	   reserve() to grow it, which keeps the current elements.
+	*/
+	template< typename T >
+	class RingBuffer {
+	public:
+		explicit RingBuffer( crimild::Size capacity = 0 )
+			: _data( capacity )
+		{
+
+		}
+
+		~RingBuffer( void )
+		{
+
+		}
+
+		crimild::Size capacity( void ) const { return _data.size(); }
+		crimild::Size size( void ) const { return _size; }
+		crimild::Bool empty( void ) const { return _size == 0; }
+		crimild::Bool full( void ) const { return _size == _data.size(); }
+
+		void clear( void )
+		{
+			_begin = 0;
+			_size = 0;
+		}
+
+		/**
+		   \brief Grows the buffer to at least the given capacity, keeping all elements
+		*/
+		void reserve( crimild::Size capacity )
+		{
+			if ( capacity <= _data.size() ) {
+				return;
+			}
+
+			std::vector< T > data( capacity );
+			for ( crimild::Size i = 0; i < _size; i++ ) {
+				data[ i ] = ( *this )[ i ];
+			}
+			_data.swap( data );
+			_begin = 0;
+		}
+
+		void push( const T &value )
+		{
+			assert( !full() && "RingBuffer is full" );
+			_data[ wrap( _begin + _size ) ] = value;
+			++_size;
+		}
+
+		T pop( void )
+		{
+			assert( !empty() && "RingBuffer is empty" );
+			auto value = _data[ _begin ];
+			_begin = wrap( _begin + 1 );
+			--_size;
+			return value;
+		}
+
+		T &front( void ) { return _data[ _begin ]; }
+		const T &front( void ) const { return _data[ _begin ]; }
+
+		T &back( void ) { return _data[ wrap( _begin + _size - 1 ) ]; }
+		const T &back( void ) const { return _data[ wrap( _begin + _size - 1 ) ]; }
+
+		T &operator[]( crimild::Size index ) { return _data[ wrap( _begin + index ) ]; }
+		const T &operator[]( crimild::Size index ) const { return _data[ wrap( _begin + index ) ]; }
+
+		/**
+		   \brief Physical slot in the underlying array for the element at index
+		*/
+		crimild::Size getSlot( crimild::Size index ) const { return wrap( _begin + index ); }
+
+		template< typename Fn >
+		void each( Fn fn ) const
+		{
+			for ( crimild::Size i = 0; i < _size; i++ ) {
+				fn( ( *this )[ i ], i );
+			}
+		}
+
+	private:
+		inline crimild::Size wrap( crimild::Size index ) const
+		{
+			return index >= _data.size() ? index - _data.size() : index;
+		}
+
+	private:
+		std::vector< T > _data;
+		crimild::Size _begin = 0;
+		crimild::Size _size = 0;
+	};
+
+}
+
+#endif
+
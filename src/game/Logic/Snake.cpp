@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Snake.hpp"
+
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+using namespace hunger;
+
+using namespace crimild;
+
+constexpr crimild::Real32 Snake::INITIAL_SPEED;
+
+Snake::Snake( crimild::Size tailLength )
+	: _tailLength( std::max< crimild::Size >( tailLength, 1 ) ),
+	  _tail( _tailLength )
+{
+
+}
+
+Snake::~Snake( void )
+{
+
+}
+
+void Snake::reset( const Vector2i &pos, Direction direction )
+{
+	_position = pos;
+	_direction = direction;
+	_stepCount = 0;
+	_speed = INITIAL_SPEED;
+
+	_tail.clear();
+}
+
+void Snake::setTailLength( crimild::Size length )
+{
+	_tailLength = std::max< crimild::Size >( length, 1 );
+	_tail.reserve( _tailLength );
+}
+
+Snake::Direction Snake::turned( Direction direction, Turn turn )
+{
+	if ( turn == Turn::LEFT ) {
+		switch ( direction ) {
+			case Direction::UP:
+				return Direction::LEFT;
+
+			case Direction::DOWN:
+				return Direction::RIGHT;
+
+			case Direction::LEFT:
+				return Direction::DOWN;
+
+			case Direction::RIGHT:
+				return Direction::UP;
+		}
+	}
+	else {
+		switch ( direction ) {
+			case Direction::UP:
+				return Direction::RIGHT;
+
+			case Direction::DOWN:
+				return Direction::LEFT;
+
+			case Direction::LEFT:
+				return Direction::UP;
+
+			case Direction::RIGHT:
+				return Direction::DOWN;
+		}
+	}
+
+	return direction;
+}
+
+Vector2i Snake::getOffset( Direction direction )
+{
+	switch ( direction ) {
+		case Direction::UP:
+			return Vector2i( 0, -1 );
+
+		case Direction::DOWN:
+			return Vector2i( 0, 1 );
+
+		case Direction::LEFT:
+			return Vector2i( -1, 0 );
+
+		case Direction::RIGHT:
+			return Vector2i( 1, 0 );
+	}
+
+	return Vector2i( 0, 0 );
+}
+
+void Snake::turn( Turn turn )
+{
+	_direction = turned( _direction, turn );
+}
+
+crimild::Bool Snake::step( Grid *grid, Grid::Pickup *pickup )
+{
+	return grid->withTopology( [ this, grid, pickup ]( const auto &topology ) {
+		return step( grid, topology, pickup );
+	});
+}
+
+void Snake::save( Snapshot &snapshot ) const
+{
+	snapshot.write( _position.x() );
+	snapshot.write( _position.y() );
+	snapshot.write( _direction );
+	snapshot.write( crimild::UInt64( _stepCount ) );
+	snapshot.write( _speed );
+	snapshot.write( crimild::UInt64( _tailLength ) );
+	snapshot.write( crimild::UInt64( _tail.size() ) );
+	for ( crimild::Size i = 0; i < _tail.size(); i++ ) {
+		snapshot.write( _tail[ i ].gridPos.x() );
+		snapshot.write( _tail[ i ].gridPos.y() );
+	}
+}
+
+crimild::Bool Snake::restore( Snapshot &snapshot, const Grid *grid )
+{
+	auto isInside = [ grid ]( crimild::Int32 x, crimild::Int32 y ) {
+		return x >= 0 && x < grid->getWidth() && y >= 0 && y < grid->getHeight();
+	};
+
+	auto x = snapshot.read< crimild::Int32 >();
+	auto y = snapshot.read< crimild::Int32 >();
+	auto direction = snapshot.read< std::underlying_type< Direction >::type >();
+	auto stepCount = snapshot.read< crimild::UInt64 >();
+	auto speed = snapshot.read< crimild::Real32 >();
+	auto tailLength = snapshot.read< crimild::UInt64 >();
+	auto tailSize = snapshot.read< crimild::UInt64 >();
+
+	if ( !snapshot.good()
+		 || !isInside( x, y )
+		 || direction < 0 || direction > static_cast< std::underlying_type< Direction >::type >( Direction::RIGHT )
+		 || !std::isfinite( speed ) || speed <= 0.0f
+		 || tailLength == 0
+		 || tailSize > tailLength ) {
+		return false;
+	}
+
+	// read the whole tail before changing anything, so a failed
+	// restore leaves the snake as it was. The vector only grows with
+	// the cells actually read, whatever the stored sizes say
+	std::vector< Vector2i > tail;
+	for ( crimild::UInt64 i = 0; i < tailSize; i++ ) {
+		auto gx = snapshot.read< crimild::Int32 >();
+		auto gy = snapshot.read< crimild::Int32 >();
+		if ( !snapshot.good() || !isInside( gx, gy ) ) {
+			return false;
+		}
+		tail.push_back( Vector2i( gx, gy ) );
+	}
+
+	// the length may be far larger than the saved tail. The buffer
+	// grows as the snake does, so only the saved cells are reserved
+	_tailLength = tailLength;
+	_tail.reserve( tail.size() );
+	_position = Vector2i( x, y );
+	_direction = static_cast< Direction >( direction );
+	_stepCount = stepCount;
+	_speed = speed;
+
+	_tail.clear();
+	for ( const auto &gridPos : tail ) {
+		_tail.push( TailSegment { gridPos, grid->gridPosToWorld( gridPos ) } );
+	}
+
+	return true;
+}
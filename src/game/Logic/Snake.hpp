@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_SNAKE_
+#define HUNGER_LOGIC_SNAKE_
+
+#include "RingBuffer.hpp"
+#include "Snapshot.hpp"
+
+#include "Components/Grid.hpp"
+
+#include <Crimild.hpp>
+
+#include <algorithm>
+
+namespace hunger {
+
+	/**
+	   \brief Scene-independent snake movement
+
+	   Holds the head position, direction and tail cells of the snake
+	   and advances them one grid cell at a time. It does not depend
+	   on nodes, clocks or renderers, so it can be driven either by the
+	   Player component or by a headless World.
+	*/
+	class Snake {
+	public:
+		enum class Direction {
+			UP,
+			DOWN,
+			LEFT,
+			RIGHT,
+		};
+
+		enum class Turn {
+			LEFT,
+			RIGHT,
+		};
+
+		struct TailSegment {
+			crimild::Vector2i gridPos;
+			crimild::Vector3f worldPos;
+		};
+
+		using Tail = RingBuffer< TailSegment >;
+
+		static constexpr crimild::Real32 INITIAL_SPEED = 10.0f;
+
+		/**
+		   \brief Direction after turning from the given one
+		*/
+		static Direction turned( Direction direction, Turn turn );
+
+		/**
+		   \brief Grid offset of one step in the given direction
+		*/
+		static crimild::Vector2i getOffset( Direction direction );
+
+	public:
+		explicit Snake( crimild::Size tailLength = 500 );
+		~Snake( void );
+
+		void reset( const crimild::Vector2i &pos, Direction direction );
+
+		const crimild::Vector2i &getPosition( void ) const { return _position; }
+
+		Direction getDirection( void ) const { return _direction; }
+		void setDirection( Direction direction ) { _direction = direction; }
+
+		void turn( Turn turn );
+
+		/**
+		   \brief Moves the head one cell forward
+
+		   The oldest tail cell is released in the grid. Returns false
+		   if the head runs into an occupied cell. Any consumable found
+		   in the new cell is reported in pickup.
+		*/
+		crimild::Bool step( Grid *grid, Grid::Pickup *pickup = nullptr );
+
+		/**
+		   \brief Same as step( grid, pickup ), with the given topology for the grid's size
+
+		   step( grid, pickup ) already picks a compile-time topology
+		   when there is one. This is for comparing both paths.
+		*/
+		template< typename Topology >
+		crimild::Bool step( Grid *grid, const Topology &topology, Grid::Pickup *pickup = nullptr )
+		{
+			auto pos = _position + getOffset( _direction );
+
+			if ( !grid->move( topology, pos, pickup ) ) {
+				return false;
+			}
+
+			_position = pos;
+
+			while ( !_tail.empty() && _tail.size() >= _tailLength ) {
+				grid->setEmpty( topology, _tail.pop().gridPos, true );
+			}
+			if ( _tail.full() ) {
+				// restored snakes reserve only the cells they had
+				_tail.reserve( std::min( _tailLength, 2 * _tail.capacity() + 1 ) );
+			}
+			_tail.push( TailSegment { pos, grid->gridPosToWorld( pos ) } );
+
+			++_stepCount;
+
+			return true;
+		}
+
+		crimild::Size getStepCount( void ) const { return _stepCount; }
+
+		/**
+		   \brief Steps per second. Reset to INITIAL_SPEED on reset()
+		*/
+		crimild::Real32 getSpeed( void ) const { return _speed; }
+		void setSpeed( crimild::Real32 speed ) { _speed = speed; }
+
+		/**
+		   \brief Occupied cells, from the oldest to the head
+		*/
+		const Tail &getTail( void ) const { return _tail; }
+
+		crimild::Size getTailLength( void ) const { return _tailLength; }
+
+		/**
+		   \brief Changes the number of cells occupied by the snake
+
+		   Growing reserves space right away. Shrinking releases the
+		   extra cells on the next step.
+		*/
+		void setTailLength( crimild::Size length );
+
+		void save( Snapshot &snapshot ) const;
+
+		/**
+		   \brief Restores a state written by save()
+
+		   World positions are not stored, so they're computed again
+		   from the grid. Returns false if the snapshot is truncated or
+		   holds values that don't fit the grid, in which case the snake
+		   is left untouched.
+		*/
+		crimild::Bool restore( Snapshot &snapshot, const Grid *grid );
+
+	private:
+		crimild::Vector2i _position;
+		Direction _direction = Direction::UP;
+		crimild::Size _tailLength;
+		Tail _tail;
+		crimild::Size _stepCount = 0;
+		crimild::Real32 _speed = INITIAL_SPEED;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_SNAPSHOT_
+#define HUNGER_LOGIC_SNAPSHOT_
+
+#include <Crimild.hpp>
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Binary image of a game state
+
+	   Values are stored back to back as raw bytes in the order they
+	   are written, and must be read back in the same order. Snapshots
+	   are meant to be restored by the same build in the same process
+	   (i.e. for restarting a game), so they're not portable across
+	   architectures.
+	*/
+	class Snapshot {
+	public:
+		Snapshot( void ) { }
+		~Snapshot( void ) { }
+
+		void clear( void )
+		{
+			_data.clear();
+			_offset = 0;
+			_good = true;
+		}
+
+		const std::vector< crimild::UInt8 > &getData( void ) const { return _data; }
+		crimild::Size getSize( void ) const { return _data.size(); }
+
+		/**
+		   \brief Moves the read position back to the beginning
+		*/
+		void rewind( void )
+		{
+			_offset = 0;
+			_good = true;
+		}
+
+		/**
+		   \brief False if a read went past the end of the data
+		*/
+		crimild::Bool good( void ) const { return _good; }
+
+		void write( const void *data, crimild::Size size )
+		{
+			auto bytes = static_cast< const crimild::UInt8 * >( data );
+			_data.insert( _data.end(), bytes, bytes + size );
+		}
+
+		template< typename T >
+		void write( const T &value )
+		{
+			static_assert( std::is_trivially_copyable< T >::value, "Only trivially copyable values can be written" );
+			write( &value, sizeof( T ) );
+		}
+
+		void read( void *data, crimild::Size size )
+		{
+			if ( !_good || _offset + size > _data.size() ) {
+				_good = false;
+				std::memset( data, 0, size );
+				return;
+			}
+
+			std::memcpy( data, _data.data() + _offset, size );
+			_offset += size;
+		}
+
+		template< typename T >
+		T read( void )
+		{
+			static_assert( std::is_trivially_copyable< T >::value, "Only trivially copyable values can be read" );
+			T value;
+			read( &value, sizeof( T ) );
+			return value;
+		}
+
+	private:
+		std::vector< crimild::UInt8 > _data;
+		crimild::Size _offset = 0;
+		crimild::Bool _good = true;
+	};
+
+}
+
+#endif
+
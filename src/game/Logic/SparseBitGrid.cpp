@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SparseBitGrid.hpp"
+
+#include <algorithm>
+
+using namespace hunger;
+
+constexpr crimild::Int32 SparseBitGrid::CHUNK_SIZE;
+constexpr crimild::UInt64 SparseBitGrid::EMPTY_KEY;
+
+namespace hunger {
+
+	namespace sparse {
+
+		constexpr crimild::Size INITIAL_TABLE_SIZE = 64;
+
+	}
+
+}
+
+SparseBitGrid::SparseBitGrid( crimild::Int32 width, crimild::Int32 height )
+	: _width( width ),
+	  _height( height )
+{
+	resizeTable( sparse::INITIAL_TABLE_SIZE );
+}
+
+SparseBitGrid::~SparseBitGrid( void )
+{
+
+}
+
+void SparseBitGrid::set( crimild::Int32 x, crimild::Int32 y, crimild::Bool value )
+{
+	auto key = getKey( x >> 6, y >> 6 );
+	auto chunk = findAndCacheChunk( key );
+	if ( chunk < 0 ) {
+		if ( !value ) {
+			return;
+		}
+		chunk = createChunk( key );
+	}
+
+	auto &c = _chunks[ chunk ];
+	auto &w = c.rows[ y & 63 ];
+	auto bit = Word( 1 ) << ( x & 63 );
+	if ( ( ( w & bit ) != 0 ) == value ) {
+		return;
+	}
+
+	if ( value ) {
+		w |= bit;
+		++c.population;
+		++_count;
+	}
+	else {
+		w &= ~bit;
+		--c.population;
+		--_count;
+		if ( c.population == 0 ) {
+			releaseChunk( key );
+		}
+	}
+}
+
+void SparseBitGrid::clear( void )
+{
+	for ( auto &slot : _table ) {
+		if ( slot.key != EMPTY_KEY ) {
+			_freeChunks.push_back( slot.chunk );
+			slot.key = EMPTY_KEY;
+		}
+	}
+	_used = 0;
+	_count = 0;
+	_cachedKey = EMPTY_KEY;
+	_cachedChunk = -1;
+}
+
+crimild::Size SparseBitGrid::getMemoryUsage( void ) const
+{
+	return _chunks.capacity() * sizeof( Chunk )
+		+ _freeChunks.capacity() * sizeof( crimild::Int32 )
+		+ _table.capacity() * sizeof( Slot );
+}
+
+void SparseBitGrid::setChunk( crimild::Int32 chunkX, crimild::Int32 chunkY, const Word *rows )
+{
+	auto key = getKey( chunkX, chunkY );
+
+	crimild::Int32 population = 0;
+	for ( crimild::Int32 i = 0; i < CHUNK_SIZE; i++ ) {
+		population += bits::popCount( rows[ i ] );
+	}
+
+	auto chunk = findAndCacheChunk( key );
+	if ( chunk >= 0 ) {
+		_count -= _chunks[ chunk ].population;
+		if ( population == 0 ) {
+			releaseChunk( key );
+			return;
+		}
+	}
+	else if ( population == 0 ) {
+		return;
+	}
+	else {
+		chunk = createChunk( key );
+	}
+
+	auto &c = _chunks[ chunk ];
+	std::copy( rows, rows + CHUNK_SIZE, c.rows );
+	c.population = population;
+	_count += population;
+}
+
+crimild::Int32 SparseBitGrid::createChunk( crimild::UInt64 key )
+{
+	if ( 2 * ( _used + 1 ) > _table.size() ) {
+		resizeTable( 2 * _table.size() );
+	}
+
+	crimild::Int32 chunk;
+	if ( !_freeChunks.empty() ) {
+		chunk = _freeChunks.back();
+		_freeChunks.pop_back();
+	}
+	else {
+		chunk = crimild::Int32( _chunks.size() );
+		_chunks.emplace_back();
+	}
+
+	auto &c = _chunks[ chunk ];
+	std::fill( c.rows, c.rows + CHUNK_SIZE, 0 );
+	c.population = 0;
+
+	auto mask = _table.size() - 1;
+	auto i = getHome( key );
+	while ( _table[ i ].key != EMPTY_KEY ) {
+		i = ( i + 1 ) & mask;
+	}
+	_table[ i ].key = key;
+	_table[ i ].chunk = chunk;
+	++_used;
+
+	_cachedKey = key;
+	_cachedChunk = chunk;
+
+	return chunk;
+}
+
+void SparseBitGrid::releaseChunk( crimild::UInt64 key )
+{
+	auto mask = _table.size() - 1;
+	auto i = getHome( key );
+	while ( _table[ i ].key != key ) {
+		i = ( i + 1 ) & mask;
+	}
+
+	_freeChunks.push_back( _table[ i ].chunk );
+
+	// Shift back the entries that follow, so lookups never need
+	// tombstones. An entry moves into the hole unless its home lies
+	// cyclically in (hole, entry].
+	auto j = i;
+	while ( true ) {
+		j = ( j + 1 ) & mask;
+		if ( _table[ j ].key == EMPTY_KEY ) {
+			break;
+		}
+		auto home = getHome( _table[ j ].key );
+		auto stays = i <= j ? ( i < home && home <= j ) : ( i < home || home <= j );
+		if ( !stays ) {
+			_table[ i ] = _table[ j ];
+			i = j;
+		}
+	}
+	_table[ i ].key = EMPTY_KEY;
+	--_used;
+
+	_cachedKey = EMPTY_KEY;
+	_cachedChunk = -1;
+}
+
+void SparseBitGrid::resizeTable( crimild::Size capacity )
+{
+	std::vector< Slot > old( capacity, Slot { EMPTY_KEY, -1 } );
+	std::swap( old, _table );
+
+	_shift = 64;
+	for ( auto c = capacity; c > 1; c >>= 1 ) {
+		--_shift;
+	}
+
+	auto mask = capacity - 1;
+	for ( const auto &slot : old ) {
+		if ( slot.key != EMPTY_KEY ) {
+			auto i = getHome( slot.key );
+			while ( _table[ i ].key != EMPTY_KEY ) {
+				i = ( i + 1 ) & mask;
+			}
+			_table[ i ] = slot;
+		}
+	}
+
+	_cachedKey = EMPTY_KEY;
+	_cachedChunk = -1;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_SPARSE_BIT_GRID_
+#define HUNGER_LOGIC_SPARSE_BIT_GRID_
+
+#include "BitGrid.hpp"
+
+#include <Crimild.hpp>
+
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief A 2D array of bits stored in lazily allocated chunks
+
+	   Cells are grouped in chunks of CHUNK_SIZE x CHUNK_SIZE bits, one
+	   word per chunk row. A chunk is only allocated when one of its
+	   bits is set, and it's released as soon as all of them are clear,
+	   so memory follows the set area and not the grid area.
+
+	   Chunks are found through an open addressing hash table. The
+	   last chunk written is cached, since consecutive queries (like
+	   the ones made by a moving snake) usually hit the same chunk.
+	   Const queries read the cache but never update it, so several
+	   threads may query the grid at once as long as none writes.
+	   Released chunks are kept in a pool and reused.
+	*/
+	class SparseBitGrid {
+	public:
+		using Word = BitGrid::Word;
+
+		static constexpr crimild::Int32 CHUNK_SIZE = 64;
+
+		struct Chunk {
+			Word rows[ CHUNK_SIZE ];
+			crimild::Int32 population;
+		};
+
+	public:
+		SparseBitGrid( crimild::Int32 width, crimild::Int32 height );
+		~SparseBitGrid( void );
+
+		crimild::Int32 getWidth( void ) const { return _width; }
+		crimild::Int32 getHeight( void ) const { return _height; }
+
+		inline crimild::Bool test( crimild::Int32 x, crimild::Int32 y ) const
+		{
+			auto chunk = findChunk( getKey( x >> 6, y >> 6 ) );
+			return chunk >= 0 && ( ( _chunks[ chunk ].rows[ y & 63 ] >> ( x & 63 ) ) & 1 );
+		}
+
+		void set( crimild::Int32 x, crimild::Int32 y, crimild::Bool value );
+
+		/**
+		   \brief Releases all chunks
+		*/
+		void clear( void );
+
+		/**
+		   \brief Number of set bits in the whole grid
+		*/
+		crimild::Size count( void ) const { return _count; }
+
+		/**
+		   \brief Number of chunks in use
+		*/
+		crimild::Size getChunkCount( void ) const { return _chunks.size() - _freeChunks.size(); }
+
+		/**
+		   \brief Bytes used by chunks (including pooled ones) and the hash table
+		*/
+		crimild::Size getMemoryUsage( void ) const;
+
+		/**
+		   \brief Calls fn( chunkX, chunkY, chunk ) for every chunk in use, in no particular order
+		*/
+		template< typename Fn >
+		void eachChunk( Fn fn ) const
+		{
+			for ( const auto &slot : _table ) {
+				if ( slot.key != EMPTY_KEY ) {
+					fn( crimild::Int32( slot.key & 0xFFFFFFFF ), crimild::Int32( slot.key >> 32 ), _chunks[ slot.chunk ] );
+				}
+			}
+		}
+
+		/**
+		   \brief Replaces the chunk at the given chunk coordinates
+
+		   Used to restore saved grids. All-zero rows release the chunk.
+		*/
+		void setChunk( crimild::Int32 chunkX, crimild::Int32 chunkY, const Word *rows );
+
+	private:
+		static constexpr crimild::UInt64 EMPTY_KEY = ~crimild::UInt64( 0 );
+
+		struct Slot {
+			crimild::UInt64 key;
+			crimild::Int32 chunk;
+		};
+
+		static inline crimild::UInt64 getKey( crimild::Int32 chunkX, crimild::Int32 chunkY )
+		{
+			return ( crimild::UInt64( crimild::UInt32( chunkY ) ) << 32 ) | crimild::UInt32( chunkX );
+		}
+
+		inline crimild::Size getHome( crimild::UInt64 key ) const
+		{
+			// Fibonacci hashing. Neighbor chunks land far from each other
+			return crimild::Size( ( key * 0x9E3779B97F4A7C15ull ) >> _shift );
+		}
+
+		/**
+		   \brief Index of the chunk with the given key, or -1 if it's not allocated
+		*/
+		inline crimild::Int32 findChunk( crimild::UInt64 key ) const
+		{
+			if ( key == _cachedKey ) {
+				return _cachedChunk;
+			}
+
+			auto mask = _table.size() - 1;
+			for ( auto i = getHome( key ); ; i = ( i + 1 ) & mask ) {
+				const auto &slot = _table[ i ];
+				if ( slot.key == key ) {
+					return slot.chunk;
+				}
+				if ( slot.key == EMPTY_KEY ) {
+					return -1;
+				}
+			}
+		}
+
+		/**
+		   \brief Same as findChunk(), and caches the result
+		*/
+		inline crimild::Int32 findAndCacheChunk( crimild::UInt64 key )
+		{
+			_cachedChunk = findChunk( key );
+			_cachedKey = key;
+			return _cachedChunk;
+		}
+
+		crimild::Int32 createChunk( crimild::UInt64 key );
+		void releaseChunk( crimild::UInt64 key );
+		void resizeTable( crimild::Size capacity );
+
+	private:
+		crimild::Int32 _width;
+		crimild::Int32 _height;
+		crimild::Size _count = 0;
+
+		std::vector< Chunk > _chunks;
+		std::vector< crimild::Int32 > _freeChunks;
+
+		/**
+		   Linear probing, with at most half of the slots in use.
+		   _shift turns a 64-bit hash into a slot index.
+		*/
+		std::vector< Slot > _table;
+		crimild::Size _used = 0;
+		crimild::Int32 _shift = 0;
+
+		crimild::UInt64 _cachedKey = EMPTY_KEY;
+		crimild::Int32 _cachedChunk = -1;
+	};
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "TrailPath.hpp"
+
+#include <cmath>
+
+using namespace hunger;
+
+using namespace crimild;
+
+TrailPath::TrailPath( void )
+{
+
+}
+
+TrailPath::~TrailPath( void )
+{
+
+}
+
+void TrailPath::clear( void )
+{
+	_originX.clear();
+	_originY.clear();
+	_originZ.clear();
+	_directionX.clear();
+	_directionY.clear();
+	_directionZ.clear();
+	_start.clear();
+	_first = 0;
+	_end = 0.0f;
+}
+
+void TrailPath::push( const Vector3f &from, const Vector3f &to )
+{
+	auto dx = to.x() - from.x();
+	auto dy = to.y() - from.y();
+	auto dz = to.z() - from.z();
+	auto l = std::sqrt( dx * dx + dy * dy + dz * dz );
+	if ( l > 0.0f ) {
+		dx /= l;
+		dy /= l;
+		dz /= l;
+	}
+
+	_originX.push_back( from.x() );
+	_originY.push_back( from.y() );
+	_originZ.push_back( from.z() );
+	_directionX.push_back( dx );
+	_directionY.push_back( dy );
+	_directionZ.push_back( dz );
+	_start.push_back( _end );
+	_end += l;
+}
+
+void TrailPath::pop( void )
+{
+	if ( empty() ) {
+		return;
+	}
+
+	++_first;
+	if ( empty() ) {
+		clear();
+	}
+	else if ( 2 * _first >= _start.size() ) {
+		compact();
+	}
+}
+
+void TrailPath::compact( void )
+{
+	// at least as many segments were dropped since the last time as
+	// are moved here, so this is constant time per pop on average
+	auto erase = [ this ]( std::vector< crimild::Real32 > &values ) {
+		values.erase( values.begin(), values.begin() + _first );
+	};
+	erase( _originX );
+	erase( _originY );
+	erase( _originZ );
+	erase( _directionX );
+	erase( _directionY );
+	erase( _directionZ );
+	erase( _start );
+	_first = 0;
+
+	// keep arc lengths small, so they don't lose precision over long games
+	auto base = _start[ 0 ];
+	for ( auto &start : _start ) {
+		start -= base;
+	}
+	_end -= base;
+}
+
+TrailView TrailPath::getView( void ) const
+{
+	TrailView view;
+	view.originX = _originX.data() + _first;
+	view.originY = _originY.data() + _first;
+	view.originZ = _originZ.data() + _first;
+	view.directionX = _directionX.data() + _first;
+	view.directionY = _directionY.data() + _first;
+	view.directionZ = _directionZ.data() + _first;
+	view.start = _start.data() + _first;
+	view.segmentCount = getSegmentCount();
+	view.length = getLength();
+	return view;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_TRAIL_PATH_
+#define HUNGER_LOGIC_TRAIL_PATH_
+
+#include <Crimild.hpp>
+
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Read-only view of a trail, as segments in structure-of-arrays form
+
+	   Segment i starts at origin i and covers arc lengths
+	   [start[ i ], start[ i ] + length i) along the trail, moving in
+	   the (unit) direction i. The first segment doesn't necessarily
+	   start at zero, so the whole trail covers
+	   [start[ 0 ], start[ 0 ] + length). The view doesn't own its
+	   arrays.
+	*/
+	struct TrailView {
+		const crimild::Real32 *originX = nullptr;
+		const crimild::Real32 *originY = nullptr;
+		const crimild::Real32 *originZ = nullptr;
+		const crimild::Real32 *directionX = nullptr;
+		const crimild::Real32 *directionY = nullptr;
+		const crimild::Real32 *directionZ = nullptr;
+		const crimild::Real32 *start = nullptr;
+		crimild::Size segmentCount = 0;
+		crimild::Real32 length = 0.0f;
+	};
+
+	/**
+	   \brief Segment tables for sampling points along the snake's tail
+
+	   Updated like the tail itself: each step appends the newest
+	   segment and drops the oldest one, so the cost doesn't depend on
+	   the tail length. Segments live in a window of the arrays that
+	   moves forward as they're dropped. Once the dropped ones fill
+	   half of the arrays, the window is moved back to the front.
+
+	   Segments that wrap around the grid are pushed with zero length,
+	   so they're never sampled.
+	*/
+	class TrailPath {
+	public:
+		TrailPath( void );
+		~TrailPath( void );
+
+		void clear( void );
+
+		/**
+		   \brief Appends a segment after the newest one. Pass from == to for a gap
+		*/
+		void push( const crimild::Vector3f &from, const crimild::Vector3f &to );
+
+		/**
+		   \brief Drops the oldest segment
+		*/
+		void pop( void );
+
+		crimild::Size getSegmentCount( void ) const { return _start.size() - _first; }
+		crimild::Real32 getLength( void ) const { return empty() ? 0.0f : _end - _start[ _first ]; }
+		crimild::Bool empty( void ) const { return getSegmentCount() == 0; }
+
+		/**
+		   \brief Valid until the path is changed
+		*/
+		TrailView getView( void ) const;
+
+	private:
+		void compact( void );
+
+	private:
+		std::vector< crimild::Real32 > _originX;
+		std::vector< crimild::Real32 > _originY;
+		std::vector< crimild::Real32 > _originZ;
+		std::vector< crimild::Real32 > _directionX;
+		std::vector< crimild::Real32 > _directionY;
+		std::vector< crimild::Real32 > _directionZ;
+		std::vector< crimild::Real32 > _start;
+
+		/**
+		   Index of the oldest segment, and arc length at the end of the newest one
+		*/
+		crimild::Size _first = 0;
+		crimild::Real32 _end = 0.0f;
+	};
+
+}
+
+#endif
+
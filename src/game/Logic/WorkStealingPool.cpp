@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "WorkStealingPool.hpp"
+
+#include <new>
+
+using namespace hunger;
+
+WorkStealingPool::WorkStealingPool( crimild::Size threadCount )
+	: _threadCount( threadCount > 0 ? threadCount : std::max< crimild::Size >( std::thread::hardware_concurrency(), 1 ) ),
+	  _rangeStorage( new char[ _threadCount * sizeof( Range ) + alignof( Range ) - 1 ] )
+{
+	void *storage = _rangeStorage.get();
+	std::size_t space = _threadCount * sizeof( Range ) + alignof( Range ) - 1;
+	_ranges = static_cast< Range * >( std::align( alignof( Range ), _threadCount * sizeof( Range ), storage, space ) );
+
+	// Range is trivially destructible, so the storage can be released as is
+	for ( crimild::Size i = 0; i < _threadCount; i++ ) {
+		new ( &_ranges[ i ] ) Range();
+		_ranges[ i ].next = 0;
+		_ranges[ i ].end = 0;
+	}
+
+	// slot 0 belongs to the calling thread
+	for ( crimild::Size i = 1; i < _threadCount; i++ ) {
+		_workers.push_back( std::thread( [ this, i ] { workerLoop( i ); } ) );
+	}
+}
+
+WorkStealingPool::~WorkStealingPool( void )
+{
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+		_stop = true;
+	}
+	_wake.notify_all();
+
+	for ( auto &worker : _workers ) {
+		worker.join();
+	}
+}
+
+void WorkStealingPool::parallelFor( crimild::Size count, crimild::Size grain, const Task &task )
+{
+	if ( count == 0 ) {
+		return;
+	}
+
+	grain = std::max< crimild::Size >( grain, 1 );
+
+	if ( _threadCount == 1 || count <= grain ) {
+		task( 0, count );
+		return;
+	}
+
+	auto perThread = ( count + _threadCount - 1 ) / _threadCount;
+	for ( crimild::Size i = 0; i < _threadCount; i++ ) {
+		auto begin = std::min( i * perThread, count );
+		_ranges[ i ].next.store( begin, std::memory_order_relaxed );
+		_ranges[ i ].end = std::min( begin + perThread, count );
+	}
+
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+		_task = &task;
+		_grain = grain;
+		_pending = _workers.size();
+		++_generation;
+	}
+	_wake.notify_all();
+
+	work( 0 );
+
+	std::unique_lock< std::mutex > lock( _mutex );
+	_done.wait( lock, [ this ] { return _pending == 0; } );
+	_task = nullptr;
+}
+
+void WorkStealingPool::workerLoop( crimild::Size slot )
+{
+	crimild::Size generation = 0;
+
+	while ( true ) {
+		{
+			std::unique_lock< std::mutex > lock( _mutex );
+			_wake.wait( lock, [ this, generation ] { return _stop || _generation != generation; } );
+			if ( _stop ) {
+				return;
+			}
+			generation = _generation;
+		}
+
+		work( slot );
+
+		{
+			std::lock_guard< std::mutex > lock( _mutex );
+			if ( --_pending == 0 ) {
+				_done.notify_one();
+			}
+		}
+	}
+}
+
+void WorkStealingPool::work( crimild::Size slot )
+{
+	const auto &task = *_task;
+	const auto grain = _grain;
+
+	// drain our own range first, then steal from the others
+	for ( crimild::Size k = 0; k < _threadCount; k++ ) {
+		auto &range = _ranges[ ( slot + k ) % _threadCount ];
+		while ( true ) {
+			auto begin = range.next.fetch_add( grain, std::memory_order_relaxed );
+			if ( begin >= range.end ) {
+				break;
+			}
+			task( begin, std::min( begin + grain, range.end ) );
+		}
+	}
+}
+
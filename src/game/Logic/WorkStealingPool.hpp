@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_WORK_STEALING_POOL_
+#define HUNGER_LOGIC_WORK_STEALING_POOL_
+
+#include <Crimild.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Persistent thread pool for data-parallel loops
+
+	   parallelFor splits [0, count) into one contiguous range per
+	   thread. Each thread takes chunks of grain items from the front
+	   of its own range, and once it runs out it steals chunks from
+	   the other ranges. Owners and thieves claim chunks with the same
+	   atomic counter, so there are no locks on the hot path and no
+	   item is ever processed twice.
+
+	   The calling thread takes part in the work. Only one
+	   parallelFor may run at a time.
+	*/
+	class WorkStealingPool {
+	public:
+		using Task = std::function< void( crimild::Size begin, crimild::Size end ) >;
+
+	public:
+		/**
+		   \param threadCount Total number of threads, including the caller.
+		   Zero means one per hardware thread.
+		*/
+		explicit WorkStealingPool( crimild::Size threadCount = 0 );
+		~WorkStealingPool( void );
+
+		crimild::Size getThreadCount( void ) const { return _threadCount; }
+
+		/**
+		   \brief Calls task on chunks of [0, count) and waits for all of them
+		*/
+		void parallelFor( crimild::Size count, crimild::Size grain, const Task &task );
+
+	private:
+		void workerLoop( crimild::Size slot );
+		void work( crimild::Size slot );
+
+	private:
+		/**
+		   Aligned to its own cache line so threads claiming chunks from
+		   different ranges don't contend with each other
+		*/
+		struct alignas( 64 ) Range {
+			std::atomic< crimild::Size > next;
+			crimild::Size end;
+		};
+
+		crimild::Size _threadCount;
+
+		/**
+		   operator new doesn't honour over-aligned types before C++17,
+		   so the ranges live in a raw buffer aligned by hand
+		*/
+		std::unique_ptr< char[] > _rangeStorage;
+		Range *_ranges = nullptr;
+		std::vector< std::thread > _workers;
+
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		std::condition_variable _done;
+		crimild::Size _generation = 0;
+		crimild::Size _pending = 0;
+		crimild::Bool _stop = false;
+
+		const Task *_task = nullptr;
+		crimild::Size _grain = 1;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "World.hpp"
+
+using namespace hunger;
+using namespace hunger::messaging;
+
+using namespace crimild;
+
+World::World( crimild::Int32 width, crimild::Int32 height, crimild::Size consumableCount, crimild::UInt64 seed )
+	: _grid( crimild::alloc< Grid >( width, height, seed ) ),
+	  _consumableCount( consumableCount )
+{
+	_grid->getEvents().pickup.subscribe< World, &World::onPickup >( this );
+
+	reset();
+}
+
+World::~World( void )
+{
+
+}
+
+void World::reset( void )
+{
+	_grid->clear();
+	_pickupCount = 0;
+
+	populate( getGrid(), _snake, _consumableCount );
+}
+
+void World::populate( Grid *grid, Snake &snake, crimild::Size consumableCount )
+{
+	Vector2i pos;
+	grid->sampleFreeCell( pos );
+	auto d = static_cast< Snake::Direction >( grid->getRandom().gameplay.generate( 4 ) );
+	snake.reset( pos, d );
+
+	Vector2i cell;
+	for ( crimild::Size i = 0; i < consumableCount; i++ ) {
+		grid->spawnConsumable( cell );
+	}
+}
+
+crimild::Bool World::step( void )
+{
+	auto &events = _grid->getEvents();
+
+	Grid::Pickup pickup;
+	if ( !_snake.step( getGrid(), &pickup ) ) {
+		return false;
+	}
+
+	if ( pickup.size > 0 ) {
+		events.pickup.push( PickupEvent { _snake.getPosition(), pickup.size, pickup.consumable, _snake.getStepCount() } );
+	}
+
+	events.flush();
+
+	return true;
+}
+
+void World::onPickup( const PickupEvent & )
+{
+	++_pickupCount;
+
+	Vector2i cell;
+	_grid->spawnConsumable( cell );
+}
+
+
+void World::save( Snapshot &snapshot ) const
+{
+	_grid->save( snapshot );
+	_snake.save( snapshot );
+}
+
+crimild::Bool World::restore( Snapshot &snapshot )
+{
+	// the grid is read first, so keep it in case the snake is invalid
+	Snapshot previous;
+	_grid->save( previous );
+
+	if ( !_grid->restore( snapshot ) ) {
+		return false;
+	}
+
+	if ( !_snake.restore( snapshot, getGrid() ) ) {
+		_grid->restore( previous );
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_LOGIC_WORLD_
+#define HUNGER_LOGIC_WORLD_
+
+#include "Snake.hpp"
+
+#include "Messaging/GameEvents.hpp"
+
+#include <Crimild.hpp>
+
+namespace hunger {
+
+	/**
+	   \brief A complete game without a scene graph
+
+	   Bundles a grid, a snake and a set of consumables so the game
+	   logic can be stepped without nodes, renderers or wall-clock
+	   time. Used by the headless driver.
+
+	   Each world owns its random streams (through its grid) and shares
+	   no state with other worlds, so different worlds can be stepped
+	   concurrently. Worlds created with the same seed and driven with
+	   the same turns replay exactly the same game.
+	*/
+	class World {
+	public:
+		World( crimild::Int32 width, crimild::Int32 height, crimild::Size consumableCount = 5, crimild::UInt64 seed = 0 );
+		~World( void );
+
+		// subscribed to its grid's events by address
+		World( const World & ) = delete;
+		World &operator=( const World & ) = delete;
+
+		Grid *getGrid( void ) { return crimild::get_ptr( _grid ); }
+		Snake &getSnake( void ) { return _snake; }
+
+		void reset( void );
+
+		/**
+		   \brief Places the snake and count consumables on a cleared grid
+
+		   Shared by reset() and Player::restart(), so a restarted game
+		   starts exactly like a new world with the same seed.
+		*/
+		static void populate( Grid *grid, Snake &snake, crimild::Size consumableCount );
+
+		/**
+		   \brief Advances the game by one fixed step
+
+		   Returns false when the snake collides with itself
+		*/
+		crimild::Bool step( void );
+
+		crimild::Size getPickupCount( void ) const { return _pickupCount; }
+
+		/**
+		   \brief Writes the grid and the snake, in the same layout as Player::save()
+		*/
+		void save( Snapshot &snapshot ) const;
+
+		/**
+		   \brief Restores a snapshot taken from a world or player of the same size
+
+		   Returns false if either part is invalid, leaving the world as it was.
+		*/
+		crimild::Bool restore( Snapshot &snapshot );
+
+	private:
+		void onPickup( const messaging::PickupEvent &event );
+
+	private:
+		crimild::SharedPointer< Grid > _grid;
+		Snake _snake;
+		crimild::Size _consumableCount;
+		crimild::Size _pickupCount = 0;
+	};
+
+}
+
+#endif
+
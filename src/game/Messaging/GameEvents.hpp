@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_MESSAGING_GAME_EVENTS_
+#define HUNGER_MESSAGING_GAME_EVENTS_
+
+#include "Logic/EventChannel.hpp"
+
+#include <Crimild.hpp>
+
+namespace hunger {
+
+	class Consumable;
+
+	namespace messaging {
+
+		/**
+		   \brief The snake ate a consumable. It's no longer registered in the grid
+		*/
+		struct PickupEvent {
+			crimild::Vector2i cell;
+			crimild::Int32 size;
+			Consumable *consumable;
+			crimild::Size step;
+		};
+
+		/**
+		   \brief Gameplay events of a single world, flushed at the end of each step
+
+		   Owned by the world's Grid. Game over happens once per game
+		   and is only of interest to the UI, so it's still broadcast
+		   as a GameOver message.
+		*/
+		struct GameEvents {
+			EventChannel< PickupEvent > pickup;
+
+			void flush( void )
+			{
+				pickup.flush();
+			}
+
+			void clear( void )
+			{
+				pickup.clear();
+			}
+		};
+
+	}
+
+}
+
+#endif
@@ -36,6 +36,11 @@ namespace hunger {
 
 		struct StartGame { };
 
+		/**
+		   \brief Sent when a game is restarted in place, without rebuilding the scene
+		*/
+		struct GameRestarted { };
+
 		struct GameOver { };
 
 		struct QuitGame { };
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "StreamingVertexBufferObjectCatalog.hpp"
+
+#include <algorithm>
+
+using namespace hunger;
+
+using namespace crimild;
+
+constexpr crimild::Size StreamingVertexBufferObjectCatalog::MAX_DIRTY_RANGES;
+
+StreamingVertexBufferObjectCatalog::StreamingVertexBufferObjectCatalog( void )
+{
+
+}
+
+StreamingVertexBufferObjectCatalog::~StreamingVertexBufferObjectCatalog( void )
+{
+
+}
+
+void StreamingVertexBufferObjectCatalog::markDirty( VertexBufferObject *vbo, crimild::Size first, crimild::Size count )
+{
+	if ( vbo == nullptr || vbo->getCatalog() != this ) {
+		// uploaded in full when loaded
+		return;
+	}
+
+	Range range { first, std::min< crimild::Size >( first + count, vbo->getVertexCount() ) };
+	if ( range.begin >= range.end ) {
+		return;
+	}
+
+	auto &ranges = _dirty[ vbo ];
+	for ( auto &r : ranges ) {
+		if ( range.begin <= r.end && r.begin <= range.end ) {
+			// overlapping or adjacent
+			r.begin = std::min( r.begin, range.begin );
+			r.end = std::max( r.end, range.end );
+			return;
+		}
+	}
+
+	if ( ranges.size() >= MAX_DIRTY_RANGES ) {
+		for ( const auto &r : ranges ) {
+			range.begin = std::min( range.begin, r.begin );
+			range.end = std::max( range.end, r.end );
+		}
+		ranges.clear();
+	}
+
+	ranges.push_back( range );
+}
+
+void StreamingVertexBufferObjectCatalog::bind( ShaderProgram *program, VertexBufferObject *vbo )
+{
+	opengl::VertexBufferObjectCatalog::bind( program, vbo );
+
+	auto it = _dirty.find( vbo );
+	if ( it == _dirty.end() || it->second.empty() ) {
+		return;
+	}
+
+	const auto stride = vbo->getVertexFormat().getVertexSizeInBytes();
+	auto data = reinterpret_cast< const crimild::UInt8 * >( vbo->getData() );
+
+	glBindBuffer( GL_ARRAY_BUFFER, vbo->getCatalogId() );
+	for ( const auto &r : it->second ) {
+		glBufferSubData( GL_ARRAY_BUFFER, r.begin * stride, ( r.end - r.begin ) * stride, data + r.begin * stride );
+	}
+
+	// keeps its storage for the next frame
+	it->second.clear();
+}
+
+void StreamingVertexBufferObjectCatalog::unload( VertexBufferObject *vbo )
+{
+	_dirty.erase( vbo );
+
+	opengl::VertexBufferObjectCatalog::unload( vbo );
+}
+
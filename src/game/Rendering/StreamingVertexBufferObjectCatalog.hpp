@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HUNGER_RENDERING_STREAMING_VERTEX_BUFFER_OBJECT_CATALOG_
+#define HUNGER_RENDERING_STREAMING_VERTEX_BUFFER_OBJECT_CATALOG_
+
+#include <Crimild.hpp>
+#include <Crimild_OpenGL.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace hunger {
+
+	/**
+	   \brief Vertex buffer catalog that can update part of a loaded buffer
+
+	   Vertices marked with markDirty() are sent with glBufferSubData
+	   the next time the buffer is bound, instead of unloading it and
+	   uploading the whole buffer again. Buffers are still uploaded in
+	   full the first time they're loaded.
+	*/
+	class StreamingVertexBufferObjectCatalog : public crimild::opengl::VertexBufferObjectCatalog {
+	public:
+		/**
+		   Above this many pending ranges per buffer, they are merged
+		   into a single one
+		*/
+		static constexpr crimild::Size MAX_DIRTY_RANGES = 8;
+
+	public:
+		StreamingVertexBufferObjectCatalog( void );
+		virtual ~StreamingVertexBufferObjectCatalog( void );
+
+		/**
+		   \brief Uploads vertices [first, first + count) on the next bind
+
+		   Ignored if the buffer isn't loaded by this catalog yet, since
+		   loading uploads all of it.
+		*/
+		void markDirty( crimild::VertexBufferObject *vbo, crimild::Size first, crimild::Size count );
+
+		virtual void bind( crimild::ShaderProgram *program, crimild::VertexBufferObject *vbo ) override;
+		virtual void unload( crimild::VertexBufferObject *vbo ) override;
+
+	private:
+		struct Range {
+			crimild::Size begin;
+			crimild::Size end;
+		};
+
+		std::unordered_map< crimild::VertexBufferObject *, std::vector< Range >> _dirty;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <Crimild.hpp>
+
+#include "Logic/World.hpp"
+#include "Logic/EpisodeRunner.hpp"
+#include "Logic/RandomStream.hpp"
+#include "Logic/Replay.hpp"
+#include "Logic/AutoPlayer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace hunger;
+
+using namespace crimild;
+
+namespace hunger {
+
+	namespace headless {
+
+		struct Options {
+			crimild::Size steps = 10000000;
+			crimild::Int32 width = 100;
+			crimild::Int32 height = 100;
+			crimild::Size consumables = 5;
+			crimild::Real32 turnChance = 0.1f;
+			crimild::Size worlds = 1;
+			crimild::Size threads = 0;
+			crimild::UInt64 seed = 0;
+			std::string record;
+			std::string replay;
+			crimild::Bool autoplay = false;
+			crimild::Bool benchGrid = false;
+		};
+
+		void report( const Options &options, crimild::Size totalSteps, crimild::Size episodes, crimild::Size pickups, double seconds )
+		{
+			std::cout << "board:         " << options.width << "x" << options.height << "\n"
+					  << "worlds:        " << options.worlds << "\n"
+					  << "steps:         " << totalSteps << "\n"
+					  << "episodes:      " << episodes << "\n"
+					  << "pickups:       " << pickups << "\n"
+					  << "elapsed:       " << seconds << " s\n"
+					  << "steps/second:  " << ( seconds > 0.0 ? totalSteps / seconds : 0.0 ) << "\n";
+		}
+
+		void saveRecording( const Replay &recording, const std::string &path )
+		{
+			if ( !recording.save( path ) ) {
+				std::cerr << "Cannot save recording to " << path << "\n";
+			}
+		}
+
+		/**
+		   \brief Steps a single world on the calling thread
+		*/
+		void runSingle( const Options &options )
+		{
+			World world( options.width, options.height, options.consumables, options.seed );
+
+			// the driver's decisions must be reproducible too
+			RandomStream random( options.seed );
+
+			// when autoplaying, the time spent deciding is reported too
+			std::unique_ptr< AutoPlayer > autoPlayer;
+			if ( options.autoplay ) {
+				if ( world.getGrid()->isSparse() ) {
+					// its bitboards cover the whole grid
+					std::cerr << "The autoplayer needs a dense grid. Using random turns\n";
+				}
+				else {
+					autoPlayer.reset( new AutoPlayer( options.width, options.height ) );
+				}
+			}
+			double decideTotal = 0.0;
+			double decideWorst = 0.0;
+
+			// only the first episode is recorded
+			Replay recording( options.seed, options.width, options.height, options.consumables );
+			auto recordingEpisode = !options.record.empty();
+
+			crimild::Size episodes = 1;
+			crimild::Size pickups = 0;
+
+			auto begin = std::chrono::steady_clock::now();
+
+			for ( crimild::Size i = 0; i < options.steps; i++ ) {
+				auto turning = false;
+				auto turn = Snake::Turn::LEFT;
+				if ( autoPlayer != nullptr ) {
+					auto decideBegin = std::chrono::steady_clock::now();
+					auto move = autoPlayer->decide( world.getGrid(), world.getSnake() );
+					auto elapsed = std::chrono::duration< double >( std::chrono::steady_clock::now() - decideBegin ).count();
+					decideTotal += elapsed;
+					decideWorst = std::max( decideWorst, elapsed );
+
+					turning = move != AutoPlayer::Move::STRAIGHT;
+					turn = move == AutoPlayer::Move::LEFT ? Snake::Turn::LEFT : Snake::Turn::RIGHT;
+				}
+				else if ( random.generate( 0.0f, 1.0f ) < options.turnChance ) {
+					turning = true;
+					turn = random.generate( 2 ) == 0 ? Snake::Turn::LEFT : Snake::Turn::RIGHT;
+				}
+
+				if ( turning ) {
+					if ( recordingEpisode ) {
+						recording.record( world.getSnake().getStepCount(), turn );
+					}
+					world.getSnake().turn( turn );
+				}
+
+				if ( !world.step() ) {
+					if ( recordingEpisode ) {
+						saveRecording( recording, options.record );
+						recordingEpisode = false;
+					}
+					pickups += world.getPickupCount();
+					world.reset();
+					++episodes;
+				}
+			}
+			pickups += world.getPickupCount();
+
+			if ( recordingEpisode ) {
+				// the first episode outlived the run. Its replay stops where the run did
+				saveRecording( recording, options.record );
+			}
+
+			auto end = std::chrono::steady_clock::now();
+			report( options, options.steps, episodes, pickups, std::chrono::duration< double >( end - begin ).count() );
+			std::cout << "occupancy:     " << world.getGrid()->getOccupancyMemoryUsage() << " bytes" << ( world.getGrid()->isSparse() ? " (sparse)" : "" ) << "\n";
+
+			if ( autoPlayer != nullptr && options.steps > 0 ) {
+				std::cout << "decide avg:    " << 1000.0 * decideTotal / options.steps << " ms\n"
+						  << "decide worst:  " << 1000.0 * decideWorst << " ms\n";
+			}
+		}
+
+		/**
+		   \brief Plays a recorded session as fast as possible
+
+		   Stops at game over, or after options.steps steps, whatever
+		   happens first. Useful to profile the exact state reported by
+		   a recording.
+		*/
+		crimild::Bool runReplay( const Options &options )
+		{
+			Replay replay;
+			if ( !replay.load( options.replay ) ) {
+				std::cerr << "Cannot load replay from " << options.replay << "\n";
+				return false;
+			}
+
+			World world( replay.getWidth(), replay.getHeight(), replay.getConsumableCount(), replay.getSeed() );
+			auto &snake = world.getSnake();
+
+			crimild::Size cursor = 0;
+			crimild::Bool alive = true;
+
+			auto begin = std::chrono::steady_clock::now();
+
+			while ( alive && snake.getStepCount() < options.steps ) {
+				cursor = replay.play( cursor, snake.getStepCount(), [ &snake ]( Snake::Turn turn ) {
+					snake.turn( turn );
+				});
+				alive = world.step();
+			}
+
+			auto end = std::chrono::steady_clock::now();
+
+			std::cout << "replay:        " << options.replay << "\n"
+					  << "board:         " << replay.getWidth() << "x" << replay.getHeight() << "\n"
+					  << "turns played:  " << cursor << " of " << replay.getEventCount() << "\n"
+					  << "steps:         " << snake.getStepCount() << ( alive ? "" : " (game over)" ) << "\n"
+					  << "pickups:       " << world.getPickupCount() << "\n"
+					  << "elapsed:       " << std::chrono::duration< double >( end - begin ).count() << " s\n";
+
+			return true;
+		}
+
+		/**
+		   \brief Compares the runtime grid topology with the compile-time one
+
+		   Runs the same random walk twice, once with each topology, and
+		   reports the time per snake step and per wrap and index
+		   computation alone. Only sizes covered by dispatchGridTopology()
+		   have a compile-time topology.
+		*/
+		void runGridBenchmark( const Options &options )
+		{
+			Grid grid( options.width, options.height, options.seed );
+			Snake snake;
+
+			// drawn up front, so both runs do the same work and random
+			// numbers are not part of the measurement
+			constexpr crimild::Size MOVE_COUNT = 1 << 16;
+			std::vector< crimild::Int8 > turns( MOVE_COUNT );
+			std::vector< Vector2i > offsets( MOVE_COUNT );
+			RandomStream random( options.seed );
+			for ( crimild::Size i = 0; i < MOVE_COUNT; i++ ) {
+				auto c = random.generate( 0.0f, 2.0f );
+				turns[ i ] = ( c < 1.0f ? c : c - 1.0f ) >= options.turnChance ? 0 : ( c < 1.0f ? 1 : 2 );
+				offsets[ i ] = Snake::getOffset( static_cast< Snake::Direction >( random.generate( 4 ) ) );
+			}
+
+			auto run = [ & ]( const auto &topology, const char *name ) {
+				grid.clear();
+				snake.reset( Vector2i( options.width / 2, options.height / 2 ), Snake::Direction::RIGHT );
+
+				crimild::Size episodes = 1;
+				crimild::UInt64 checksum = 0;
+
+				auto begin = std::chrono::steady_clock::now();
+
+				for ( crimild::Size i = 0; i < options.steps; i++ ) {
+					auto turn = turns[ i & ( MOVE_COUNT - 1 ) ];
+					if ( turn != 0 ) {
+						snake.turn( turn == 1 ? Snake::Turn::LEFT : Snake::Turn::RIGHT );
+					}
+
+					if ( !snake.step( &grid, topology ) ) {
+						// release only the snake's cells, clearing the whole grid would dominate
+						snake.getTail().each( [ & ]( const Snake::TailSegment &segment, crimild::Size ) {
+							grid.setEmpty( topology, segment.gridPos, true );
+						});
+						snake.reset( snake.getPosition(), snake.getDirection() );
+						++episodes;
+					}
+					checksum += topology.getIndex( snake.getPosition() );
+				}
+
+				auto middle = std::chrono::steady_clock::now();
+
+				Vector2i pos( 0, 0 );
+				for ( crimild::Size i = 0; i < options.steps; i++ ) {
+					pos = topology.wrap( pos + offsets[ i & ( MOVE_COUNT - 1 ) ] );
+					checksum += topology.getIndex( pos );
+				}
+
+				auto end = std::chrono::steady_clock::now();
+
+				auto perStep = [ &options ]( std::chrono::steady_clock::duration d ) {
+					return options.steps > 0 ? std::chrono::duration< double, std::nano >( d ).count() / options.steps : 0.0;
+				};
+
+				std::cout << name << " topology\n"
+						  << "  episodes:    " << episodes << "\n"
+						  << "  checksum:    " << checksum << "\n"
+						  << "  ns/step:     " << perStep( middle - begin ) << "\n"
+						  << "  ns/wrap:     " << perStep( end - middle ) << "\n";
+			};
+
+			std::cout << "board:         " << options.width << "x" << options.height << "\n"
+					  << "steps:         " << options.steps << "\n";
+
+			run( grid.getTopology(), "runtime" );
+
+			grid.withTopology( [ & ]( const auto &topology ) {
+				if ( std::decay< decltype( topology ) >::type::IS_STATIC ) {
+					run( topology, "static" );
+				}
+				else {
+					std::cout << "No compile-time topology for this size\n";
+				}
+			});
+		}
+
+		/**
+		   \brief Steps many worlds in parallel through the batched runner API
+
+		   options.steps counts batched steps, so the aggregate number of
+		   world steps is options.steps * options.worlds.
+		*/
+		void runBatched( const Options &options )
+		{
+			EpisodeRunner runner( options.worlds, options.width, options.height, options.consumables, options.seed, options.threads );
+			std::cout << "threads:       " << runner.getThreadCount() << "\n";
+
+			std::vector< crimild::Int8 > actions( options.worlds );
+			std::vector< EpisodeRunner::Observation > observations( options.worlds );
+			RandomStream random( options.seed );
+			std::vector< crimild::Real32 > chances( options.worlds );
+
+			runner.reset( observations.data() );
+
+			crimild::Size episodes = options.worlds;
+			crimild::Size pickups = 0;
+
+			auto begin = std::chrono::steady_clock::now();
+
+			for ( crimild::Size i = 0; i < options.steps; i++ ) {
+				random.generate( chances.data(), chances.size(), 0.0f, 2.0f );
+				for ( crimild::Size w = 0; w < options.worlds; w++ ) {
+					// below turnChance means turning; the half picks the side
+					auto c = chances[ w ];
+					auto turn = ( c < 1.0f ? c : c - 1.0f ) < options.turnChance;
+					actions[ w ] = !turn ? EpisodeRunner::ACTION_STRAIGHT : ( c < 1.0f ? EpisodeRunner::ACTION_TURN_LEFT : EpisodeRunner::ACTION_TURN_RIGHT );
+				}
+
+				runner.step( actions.data(), observations.data() );
+
+				for ( const auto &o : observations ) {
+					pickups += o.reward;
+					episodes += o.done;
+				}
+			}
+
+			auto end = std::chrono::steady_clock::now();
+			report( options, options.steps * options.worlds, episodes, pickups, std::chrono::duration< double >( end - begin ).count() );
+		}
+
+	}
+
+}
+
+/**
+   \brief Headless simulation driver
+
+   Steps the game logic as fast as possible, without a window, a
+   renderer or a particle system. Whenever the snake dies, the world
+   is reset and a new episode begins.
+
+   Usage: LD42Headless [--steps N] [--width W] [--height H] [--consumables N] [--turn-chance P] [--worlds N] [--threads N] [--seed S] [--record FILE] [--replay FILE] [--autoplay 1] [--bench-grid 1]
+*/
+int main( int argc, char **argv )
+{
+	headless::Options options;
+
+	for ( int i = 1; i < argc - 1; i++ ) {
+		if ( strcmp( argv[ i ], "--steps" ) == 0 ) options.steps = std::strtoull( argv[ ++i ], nullptr, 10 );
+		else if ( strcmp( argv[ i ], "--width" ) == 0 ) options.width = std::atoi( argv[ ++i ] );
+		else if ( strcmp( argv[ i ], "--height" ) == 0 ) options.height = std::atoi( argv[ ++i ] );
+		else if ( strcmp( argv[ i ], "--consumables" ) == 0 ) options.consumables = std::strtoull( argv[ ++i ], nullptr, 10 );
+		else if ( strcmp( argv[ i ], "--turn-chance" ) == 0 ) options.turnChance = std::atof( argv[ ++i ] );
+		else if ( strcmp( argv[ i ], "--worlds" ) == 0 ) options.worlds = std::strtoull( argv[ ++i ], nullptr, 10 );
+		else if ( strcmp( argv[ i ], "--threads" ) == 0 ) options.threads = std::strtoull( argv[ ++i ], nullptr, 10 );
+		else if ( strcmp( argv[ i ], "--seed" ) == 0 ) options.seed = std::strtoull( argv[ ++i ], nullptr, 10 );
+		else if ( strcmp( argv[ i ], "--record" ) == 0 ) options.record = argv[ ++i ];
+		else if ( strcmp( argv[ i ], "--replay" ) == 0 ) options.replay = argv[ ++i ];
+		else if ( strcmp( argv[ i ], "--autoplay" ) == 0 ) options.autoplay = std::atoi( argv[ ++i ] ) != 0;
+		else if ( strcmp( argv[ i ], "--bench-grid" ) == 0 ) options.benchGrid = std::atoi( argv[ ++i ] ) != 0;
+	}
+
+	if ( !options.replay.empty() ) {
+		return headless::runReplay( options ) ? 0 : 1;
+	}
+
+	if ( options.benchGrid ) {
+		headless::runGridBenchmark( options );
+	}
+	else if ( options.worlds > 1 ) {
+		headless::runBatched( options );
+	}
+	else {
+		headless::runSingle( options );
+	}
+
+	return 0;
+}
+
@@ -30,8 +30,15 @@
 
 #include "Messaging/Messages.hpp"
 #include "Components/Grid.hpp"
+#include "Components/GridSpawner.hpp"
 #include "Components/Player.hpp"
 #include "Components/Consumable.hpp"
+#include "Components/ProfilerOverlay.hpp"
+#include "Assets/FontCache.hpp"
+#include "Rendering/StreamingVertexBufferObjectCatalog.hpp"
+#include "Logic/Profiler.hpp"
+
+#include <random>
 
 namespace crimild {
 
@@ -54,12 +61,77 @@ using namespace crimild;
 using namespace crimild::sdl;
 using namespace crimild::messaging;
 
+static const std::string UI_FONT = "assets/fonts/Verdana.txt";
+
 #ifdef CRIMILD_PLATFORM_EMSCRIPTEN
 #define SIM_LIFETIME static
 #else
 #define SIM_LIFETIME
 #endif
 
+/**
+   \brief Session loaded from "replay=<file>", if any
+
+   Use "replay_until=<step>" to fast-forward up to that step before
+   continuing at normal speed.
+*/
+SharedPointer< Replay > getReplay( void )
+{
+	static SharedPointer< Replay > replay;
+	static crimild::Bool loaded = false;
+
+	if ( !loaded ) {
+		loaded = true;
+		auto path = Simulation::getInstance()->getSettings()->get< std::string >( "replay", "" );
+		if ( !path.empty() ) {
+			replay = crimild::alloc< Replay >();
+			if ( !replay->load( path ) ) {
+				Log::error( "Main", "Cannot load replay from ", path );
+				replay = nullptr;
+			}
+		}
+	}
+
+	return replay;
+}
+
+/**
+   \brief Saves the current game's turns if "record=<file>" was given
+*/
+void saveRecording( void )
+{
+	auto path = Simulation::getInstance()->getSettings()->get< std::string >( "record", "" );
+	auto player = Player::getInstance();
+	if ( path.empty() || player == nullptr ) {
+		return;
+	}
+
+	if ( !player->getRecording().save( path ) ) {
+		Log::error( "Main", "Cannot save recording to ", path );
+	}
+}
+
+/**
+   \brief Seed for a new game
+
+   Passing "seed=N" in the command line replays the same game for the
+   same inputs. Otherwise, every game gets a different seed.
+*/
+crimild::UInt64 getGameSeed( void )
+{
+	if ( auto replay = getReplay() ) {
+		return replay->getSeed();
+	}
+
+	auto seed = Simulation::getInstance()->getSettings()->get< std::string >( "seed", "" );
+	if ( !seed.empty() ) {
+		return std::strtoull( seed.c_str(), nullptr, 10 );
+	}
+
+	std::random_device device;
+	return ( crimild::UInt64( device() ) << 32 ) | device();
+}
+
 SharedPointer< Group > createGrid( void )
 {
 	const auto WIDTH = 100;
@@ -85,7 +157,8 @@ SharedPointer< Group > createGrid( void )
 	plane->getComponent< MaterialComponent >()->attachMaterial( planeMaterial );
 	grid->attachNode( plane );
 
-	grid->attachComponent< Grid >( WIDTH, HEIGHT );
+	grid->attachComponent< Grid >( WIDTH, HEIGHT, getGameSeed() );
+	grid->attachComponent< GridSpawner >();
 	grid->local().rotate().fromAxisAngle( Vector3f::UNIT_X, Numericf::PI );
 	return grid;
 }
@@ -101,8 +174,7 @@ SharedPointer< Camera > createCamera( void )
 
 SharedPointer< Node > createInGameUI( void )
 {
-	auto fontFileName = FileSystem::getInstance().pathForResource( "assets/fonts/Verdana.txt" );
-	auto font = crimild::alloc< Font >( fontFileName );
+	auto font = FontCache::get( UI_FONT );
 
 	auto btnMenu = crimild::alloc< Text >();
 	btnMenu->setFont( font );
@@ -118,17 +190,26 @@ SharedPointer< Node > createInGameUI( void )
 
 	auto inGameUI = crimild::alloc< Group >();
 	inGameUI->attachNode( btnMenu );
+
+	if ( Profiler::getInstance() != nullptr ) {
+		auto overlay = crimild::alloc< Group >();
+		overlay->attachComponent< ProfilerOverlay >( font );
+		inGameUI->attachNode( overlay );
+	}
 	auto weakInGameUI = crimild::get_ptr( inGameUI );
-	inGameUI->attachComponent< MessageHandlerComponent >()->registerMessageHandler< GameOver >( [ weakInGameUI ]( GameOver const & ) {
+	auto inGameHandler = inGameUI->attachComponent< MessageHandlerComponent >();
+	inGameHandler->registerMessageHandler< GameOver >( [ weakInGameUI ]( GameOver const & ) {
 		weakInGameUI->setEnabled( false );		
 	});
+	inGameHandler->registerMessageHandler< GameRestarted >( [ weakInGameUI ]( GameRestarted const & ) {
+		weakInGameUI->setEnabled( true );
+	});
 	return inGameUI;
 }
 
 SharedPointer< Node > createGameOverUI( void )
 {
-	auto fontFileName = FileSystem::getInstance().pathForResource( "assets/fonts/Verdana.txt" );
-	auto font = crimild::alloc< Font >( fontFileName );
+	auto font = FontCache::get( UI_FONT );
 
 	auto ui = crimild::alloc< Group >();
 
@@ -168,9 +249,13 @@ SharedPointer< Node > createGameOverUI( void )
 	ui->attachNode( btnQuit );
 
 	auto weakUI = crimild::get_ptr( ui );
-	ui->attachComponent< MessageHandlerComponent >()->registerMessageHandler< GameOver >( [ weakUI ]( GameOver const & ) {
+	auto handler = ui->attachComponent< MessageHandlerComponent >();
+	handler->registerMessageHandler< GameOver >( [ weakUI ]( GameOver const & ) {
 		weakUI->setEnabled( true );
 	});
+	handler->registerMessageHandler< GameRestarted >( [ weakUI ]( GameRestarted const & ) {
+		weakUI->setEnabled( false );
+	});
 
 	// required, since we're disable the node from the start
 	ui->perform( UpdateRenderState() );
@@ -204,6 +289,11 @@ SharedPointer< Group > createGameScene( void )
 	auto light = crimild::alloc< Light >( Light::Type::POINT );
 	camera->attachNode( light );
 
+	if ( Profiler::getInstance() != nullptr ) {
+		// the in-game UI is disabled on game over, but the scene is not
+		scene->attachComponent< ProfilerFrameTracker >();
+	}
+
     return scene;
 }
 
@@ -228,8 +318,7 @@ SharedPointer< Group > createMainMenuScene( void )
 
 	auto ui = crimild::alloc< Group >();
 
-	auto fontFileName = FileSystem::getInstance().pathForResource( "assets/fonts/Verdana.txt" );
-	auto font = crimild::alloc< Font >( fontFileName );
+	auto font = FontCache::get( UI_FONT );
 
 	auto lblTitle = crimild::alloc< Text >();
 	lblTitle->setFont( font );
@@ -270,6 +359,10 @@ SharedPointer< Group > createMainMenuScene( void )
 	
 	scene->attachNode( ui );
 
+	if ( Profiler::getInstance() != nullptr ) {
+		scene->attachComponent< ProfilerFrameTracker >();
+	}
+
 	return scene;
 }
 
@@ -279,16 +372,49 @@ int main( int argc, char **argv )
 
 	SIM_LIFETIME auto sim = crimild::alloc< SDLSimulation >( "LD42", crimild::alloc< Settings >( argc, argv ) );
 
+	// before anything is loaded, so the trail can update its vertex buffer in place
+	Renderer::getInstance()->setVertexBufferObjectCatalog( crimild::alloc< StreamingVertexBufferObjectCatalog >() );
+
+	// fonts are loaded once and shared by all scenes
+	FontCache::preload( { UI_FONT } );
+
+	// "profile=1" shows frame phase times in game. "profile_csv=<file>" also saves them
+	SIM_LIFETIME SharedPointer< Profiler > profiler;
+	auto profileCSV = sim->getSettings()->get< std::string >( "profile_csv", "" );
+	if ( sim->getSettings()->get< std::string >( "profile", "0" ) != "0" || !profileCSV.empty() ) {
+		profiler = crimild::alloc< Profiler >();
+		if ( !profileCSV.empty() && !profiler->openCSV( profileCSV ) ) {
+			Log::error( "Main", "Cannot write profile to ", profileCSV );
+		}
+	}
+
 	sim->registerMessageHandler< StartGame >( []( StartGame const & ) {
 		crimild::concurrency::sync_frame( [] {
+			// Restarting from game over only resets the existing scene.
+			// Replays still need a new scene to start from their seed.
+			auto player = Player::getInstance();
+			if ( player != nullptr && getReplay() == nullptr && player->restart( getGameSeed() ) ) {
+				return;
+			}
+
 			auto sim = Simulation::getInstance();
 			sim->setScene( nullptr );
-			sim->setScene( createGameScene() );
+			auto scene = createGameScene();
+			if ( auto replay = getReplay() ) {
+				auto until = sim->getSettings()->get< std::string >( "replay_until", "0" );
+				Player::getInstance()->setReplay( replay, std::strtoull( until.c_str(), nullptr, 10 ) );
+			}
+			sim->setScene( scene );
 		});
 	});
 
+	sim->registerMessageHandler< GameOver >( []( GameOver const & ) {
+		saveRecording();
+	});
+
 	sim->registerMessageHandler< QuitGame >( []( QuitGame const & ) {
 		crimild::concurrency::sync_frame( [] {
+			saveRecording();
 			auto sim = Simulation::getInstance();
 			sim->setScene( nullptr );
 			sim->setScene( createMainMenuScene() );
@@ -297,6 +423,15 @@ int main( int argc, char **argv )
 
 	sim->setScene( createMainMenuScene() );
 
-	return sim->run();
+	auto result = sim->run();
+
+#ifndef CRIMILD_PLATFORM_EMSCRIPTEN
+	// run() returns right away on the web, while the simulation keeps going
+	sim->setScene( nullptr );
+	Consumable::releaseSharedAssets();
+	FontCache::clear();
+#endif
+
+	return result;
 }
 
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2018, Hugo Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Assets/BakedFont.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace hunger;
+
+using namespace crimild;
+
+namespace hunger {
+
+	namespace baker {
+
+		struct Image {
+			crimild::UInt32 width = 0;
+			crimild::UInt32 height = 0;
+			crimild::UInt32 channels = 0;
+			std::vector< crimild::UInt8 > pixels;
+		};
+
+		crimild::Bool readFile( const std::string &fileName, std::vector< crimild::UInt8 > &data )
+		{
+			std::ifstream file( fileName, std::ios::binary );
+			if ( !file ) {
+				return false;
+			}
+
+			data.assign( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+			return true;
+		}
+
+		/**
+		   \brief Decodes an uncompressed or RLE true-color TGA
+
+		   Pixels are converted from BGR(A) to RGB(A), bottom row first.
+		*/
+		crimild::Bool loadTGA( const std::string &fileName, Image &image )
+		{
+			std::vector< crimild::UInt8 > data;
+			if ( !readFile( fileName, data ) || data.size() < 18 ) {
+				return false;
+			}
+
+			auto idLength = data[ 0 ];
+			auto type = data[ 2 ];
+			auto width = data[ 12 ] | ( data[ 13 ] << 8 );
+			auto height = data[ 14 ] | ( data[ 15 ] << 8 );
+			auto bpp = data[ 16 ];
+			auto topLeft = ( data[ 17 ] & 0x20 ) != 0;
+
+			if ( data.size() < crimild::Size( 18 ) + idLength ) {
+				return false;
+			}
+
+			if ( ( type != 2 && type != 10 ) || ( bpp != 24 && bpp != 32 ) ) {
+				std::cerr << fileName << ": only true-color TGA files are supported\n";
+				return false;
+			}
+
+			image.width = width;
+			image.height = height;
+			image.channels = bpp / 8;
+			image.pixels.resize( crimild::Size( width ) * height * image.channels );
+
+			auto src = data.data() + 18 + idLength;
+			auto end = data.data() + data.size();
+			auto pixelCount = crimild::Size( width ) * height;
+			auto pixelSize = image.channels;
+
+			std::vector< crimild::UInt8 > decoded( image.pixels.size() );
+			if ( type == 2 ) {
+				if ( src + decoded.size() > end ) {
+					return false;
+				}
+				std::memcpy( decoded.data(), src, decoded.size() );
+			}
+			else if ( !BakedFont::decodeRLE( src, end - src, pixelSize, decoded.data(), pixelCount ) ) {
+				return false;
+			}
+
+			auto rowSize = crimild::Size( width ) * pixelSize;
+			for ( crimild::Int32 y = 0; y < height; y++ ) {
+				auto srcRow = &decoded[ ( topLeft ? height - 1 - y : y ) * rowSize ];
+				auto dstRow = &image.pixels[ y * rowSize ];
+				for ( crimild::Int32 x = 0; x < width; x++ ) {
+					auto s = srcRow + x * pixelSize;
+					auto d = dstRow + x * pixelSize;
+					d[ 0 ] = s[ 2 ];
+					d[ 1 ] = s[ 1 ];
+					d[ 2 ] = s[ 0 ];
+					if ( pixelSize == 4 ) {
+						d[ 3 ] = s[ 3 ];
+					}
+				}
+			}
+
+			return true;
+		}
+
+		crimild::Bool loadGlyphs( const std::string &fileName, BakedFont::Glyph *glyphs )
+		{
+			std::ifstream file( fileName );
+			if ( !file ) {
+				return false;
+			}
+
+			std::string line;
+			while ( std::getline( file, line ) ) {
+				std::stringstream str( line );
+				crimild::Int32 symbol;
+				BakedFont::Glyph g;
+				if ( !( str >> symbol >> g.width >> g.height >> g.bearingX >> g.bearingY >> g.advance >> g.u >> g.v >> g.uOffset >> g.vOffset ) ) {
+					continue;
+				}
+				if ( symbol >= 0 && symbol < crimild::Int32( BakedFont::GLYPH_COUNT ) ) {
+					glyphs[ symbol ] = g;
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		   \brief Encodes pixels as TGA-style RLE packets
+
+		   Runs of two or more equal pixels become run packets. Everything
+		   else is grouped in raw packets.
+		*/
+		void encodeRLE( const Image &image, std::vector< crimild::UInt8 > &out )
+		{
+			if ( image.pixels.empty() ) {
+				return;
+			}
+
+			auto pixelSize = crimild::Size( image.channels );
+			auto pixelCount = image.pixels.size() / pixelSize;
+			auto pixel = [ & ]( crimild::Size i ) { return &image.pixels[ i * pixelSize ]; };
+			auto same = [ & ]( crimild::Size a, crimild::Size b ) { return std::memcmp( pixel( a ), pixel( b ), pixelSize ) == 0; };
+
+			crimild::Size i = 0;
+			while ( i < pixelCount ) {
+				crimild::Size run = 1;
+				while ( run < 128 && i + run < pixelCount && same( i, i + run ) ) {
+					run++;
+				}
+
+				if ( run > 1 ) {
+					out.push_back( crimild::UInt8( 0x80 | ( run - 1 ) ) );
+					out.insert( out.end(), pixel( i ), pixel( i ) + pixelSize );
+					i += run;
+					continue;
+				}
+
+				// raw packet, until the next run starts
+				crimild::Size count = 1;
+				while ( count < 128 && i + count < pixelCount && !( i + count + 1 < pixelCount && same( i + count, i + count + 1 ) ) ) {
+					count++;
+				}
+				out.push_back( crimild::UInt8( count - 1 ) );
+				out.insert( out.end(), pixel( i ), pixel( i ) + count * pixelSize );
+				i += count;
+			}
+		}
+
+		/**
+		   \brief Loads a baked blob back and checks it against crimild's own loaders
+
+		   Atlases are compared with what crimild's TGA loader reads, so
+		   a different row or channel order fails the bake instead of
+		   showing up as garbled text.
+		*/
+		crimild::Bool verify( const std::string &fileName, const std::string &stem, const std::vector< BakedFont::Glyph > &glyphs )
+		{
+			BakedFont baked;
+			if ( !baked.load( fileName ) ) {
+				std::cerr << fileName << ": cannot load the baked font back\n";
+				return false;
+			}
+
+			if ( std::memcmp( &baked.getGlyph( 0 ), glyphs.data(), glyphs.size() * sizeof( BakedFont::Glyph ) ) != 0 ) {
+				std::cerr << fileName << ": glyphs don't match the glyph file\n";
+				return false;
+			}
+
+			const std::string atlasFileNames[ BakedFont::ATLAS_COUNT ] = { stem + ".tga", stem + "_sdf.tga" };
+			for ( crimild::UInt32 i = 0; i < BakedFont::ATLAS_COUNT; i++ ) {
+				auto type = BakedFont::AtlasType( i );
+				const auto &atlas = baked.getAtlas( type );
+				if ( atlas.width == 0 || atlas.height == 0 ) {
+					continue;
+				}
+
+				std::vector< crimild::UInt8 > pixels;
+				if ( !baked.decodePixels( type, pixels ) ) {
+					std::cerr << fileName << ": cannot decode " << atlasFileNames[ i ] << "\n";
+					return false;
+				}
+
+				crimild::ImageTGA image( atlasFileNames[ i ] );
+				if ( crimild::UInt32( image.getWidth() ) != atlas.width || crimild::UInt32( image.getHeight() ) != atlas.height || crimild::UInt32( image.getBpp() ) != atlas.channels ) {
+					std::cerr << atlasFileNames[ i ] << ": size doesn't match crimild's TGA loader\n";
+					return false;
+				}
+
+				auto format = image.getPixelFormat();
+				auto swap = format == crimild::Image::PixelFormat::BGR || format == crimild::Image::PixelFormat::BGRA;
+				auto data = image.getData();
+				auto channels = crimild::Size( atlas.channels );
+				for ( crimild::Size p = 0; p < crimild::Size( atlas.width ) * atlas.height; p++ ) {
+					for ( crimild::Size c = 0; c < channels; c++ ) {
+						auto expected = data[ p * channels + ( swap && c < 3 ? 2 - c : c ) ];
+						if ( pixels[ p * channels + c ] != expected ) {
+							std::cerr << atlasFileNames[ i ] << ": pixel (" << p % atlas.width << ", " << p / atlas.width << ") doesn't match crimild's TGA loader\n";
+							return false;
+						}
+					}
+				}
+			}
+
+			return true;
+		}
+	}
+
+}
+
+/**
+   Bakes a text glyph file and its atlases into a single blob:
+
+   LD42FontBaker assets/fonts/Verdana.txt baked/fonts/Verdana.font
+
+   Atlases are taken from Verdana.tga and Verdana_sdf.tga, next to
+   the glyph file. The SDF atlas is optional. The blob is loaded back
+   and checked before the baker succeeds.
+*/
+int main( int argc, char **argv )
+{
+	if ( argc != 3 ) {
+		std::cerr << "Usage: " << argv[ 0 ] << " <glyphs.txt> <output.font>\n";
+		return 1;
+	}
+
+	std::string glyphFileName = argv[ 1 ];
+	auto stem = glyphFileName.substr( 0, glyphFileName.find_last_of( '.' ) );
+
+	std::vector< BakedFont::Glyph > glyphs( BakedFont::GLYPH_COUNT );
+	std::memset( glyphs.data(), 0, glyphs.size() * sizeof( BakedFont::Glyph ) );
+	if ( !baker::loadGlyphs( glyphFileName, glyphs.data() ) ) {
+		std::cerr << "Cannot read " << glyphFileName << "\n";
+		return 1;
+	}
+
+	baker::Image atlases[ BakedFont::ATLAS_COUNT ];
+	if ( !baker::loadTGA( stem + ".tga", atlases[ BakedFont::ATLAS_REGULAR ] ) ) {
+		std::cerr << "Cannot read " << stem << ".tga\n";
+		return 1;
+	}
+	baker::loadTGA( stem + "_sdf.tga", atlases[ BakedFont::ATLAS_SDF ] );
+
+	BakedFont::Header header;
+	std::memset( &header, 0, sizeof( header ) );
+	header.magic = BakedFont::MAGIC;
+	header.version = BakedFont::VERSION;
+	header.glyphCount = BakedFont::GLYPH_COUNT;
+
+	std::vector< crimild::UInt8 > packets[ BakedFont::ATLAS_COUNT ];
+	auto offset = crimild::UInt32( sizeof( BakedFont::Header ) + glyphs.size() * sizeof( BakedFont::Glyph ) );
+	for ( crimild::UInt32 i = 0; i < BakedFont::ATLAS_COUNT; i++ ) {
+		baker::encodeRLE( atlases[ i ], packets[ i ] );
+
+		auto &atlas = header.atlases[ i ];
+		atlas.width = atlases[ i ].width;
+		atlas.height = atlases[ i ].height;
+		atlas.channels = atlases[ i ].channels;
+		atlas.offset = offset;
+		atlas.size = crimild::UInt32( packets[ i ].size() );
+		offset += atlas.size;
+	}
+	header.size = offset;
+
+	std::vector< crimild::UInt8 > blob( header.size, 0 );
+	std::memcpy( blob.data(), &header, sizeof( header ) );
+	std::memcpy( blob.data() + sizeof( header ), glyphs.data(), glyphs.size() * sizeof( BakedFont::Glyph ) );
+	for ( crimild::UInt32 i = 0; i < BakedFont::ATLAS_COUNT; i++ ) {
+		if ( !packets[ i ].empty() ) {
+			std::memcpy( blob.data() + header.atlases[ i ].offset, packets[ i ].data(), packets[ i ].size() );
+		}
+	}
+
+	{
+		std::ofstream out( argv[ 2 ], std::ios::binary );
+		if ( !out.write( reinterpret_cast< const char * >( blob.data() ), blob.size() ) ) {
+			std::cerr << "Cannot write " << argv[ 2 ] << "\n";
+			return 1;
+		}
+	}
+
+	if ( !baker::verify( argv[ 2 ], stem, glyphs ) ) {
+		// don't leave a bad blob behind for the build to pick up
+		std::remove( argv[ 2 ] );
+		return 1;
+	}
+
+	std::cout << "Baked " << argv[ 2 ] << " (" << blob.size() << " bytes)\n";
+	return 0;
+}
+